@@ -10,6 +10,7 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/string_generator.hpp>
 
+#include "column_back.h"
 #include "cyclus.h"
 #include "hdf5_back.h"
 #include "pyhooks.h"
@@ -62,6 +63,16 @@ int main(int argc, char* argv[]) {
   // Tell pyne about the path to nuc data
   Env::SetNucDataPath();
 
+  // Map the precompiled nuc data snapshot if there is one
+  std::string snap = Env::nuc_data_snapshot();
+  if (fs::exists(snap)) {
+    try {
+      NucData::LoadSnapshot(snap);
+    } catch (cyclus::IOError err) {
+      Warn<IO_WARNING>(err.what());
+    }
+  }
+
   // Handle cli option flags
   ArgInfo ai;
   int ret = ParseCliArgs(&ai, argc, argv);
@@ -130,8 +141,11 @@ int main(int argc, char* argv[]) {
   std::string stem = fs::path(ai.output_path).stem().string();
   if (ext == ".h5") {
     fback = new Hdf5Back(ai.output_path.c_str());
+  } else if (ext == ".cyc") {
+    fback = new ColumnBack(ai.output_path);
   } else {
-    fback = new SqliteBack(ai.output_path);
+    bool background = ai.vm.count("background-writes") > 0;
+    fback = new SqliteBack(ai.output_path, background);
   }
   rec.RegisterBackend(fback);
   bdel.Add(fback);
@@ -196,7 +210,10 @@ int main(int argc, char* argv[]) {
     std::string ext = dbfile.extension().string();
     if (ext == ".h5") {
       rback = new Hdf5Back(dbfile.c_str());
+    } else if (ext == ".cyc") {
+      rback = new ColumnBack(dbfile.string());
     } else {
+      // the restart input is only read, so it's left unindexed
       rback = new SqliteBack(dbfile.c_str());
     }
     bdel.Add(rback);
@@ -256,6 +273,8 @@ int ParseCliArgs(ArgInfo* ai, int argc, char* argv[]) {
       ("verb,v", po::value<std::string>(),
        "log verbosity. integer from 0 (quiet) to 11 (verbose).")
       ("output-path,o", po::value<std::string>(), "output path")
+      ("background-writes", "write sqlite output from a separate thread in "
+       "WAL mode so it can be read during the simulation")
       ("input-file,i", po::value<std::string>(),
        "input file, may be a path or a raw string")
       ("format,f", po::value<std::string>()->default_value("none"),
@@ -270,6 +289,9 @@ int ParseCliArgs(ArgInfo* ai, int argc, char* argv[]) {
       ("build-path", "print the cyclus build directory")
       ("rng-schema", "print the path to cyclus.rng.in")
       ("nuc-data", "print the path to cyclus_nuc_data.h5")
+      ("compile-nuc-data", "write a memory-mappable snapshot of the nuclear "
+       "data to CYCLUS_NUC_DATA_SNAPSHOT (default: the nuc-data path + .snap) "
+       "that later runs load at startup")
       ("json-to-xml", po::value<std::string>(), "*.json input file")
       ("xml-to-json", po::value<std::string>(), "*.xml input file")
       ("json-to-py", po::value<std::string>(), "*.json input file")
@@ -341,6 +363,16 @@ int EarlyExitArgs(const ArgInfo& ai) {
   } else if (ai.vm.count("nuc-data")) {
     std::cout << Env::nuc_data() << "\n";
     return 0;
+  } else if (ai.vm.count("compile-nuc-data")) {
+    std::string snap = Env::nuc_data_snapshot();
+    try {
+      NucData::Compile(snap);
+    } catch (cyclus::IOError err) {
+      std::cout << err.what() << "\n";
+      return 1;
+    }
+    std::cout << snap << "\n";
+    return 0;
   } else if (ai.vm.count("schema")) {
     std::stringstream f;
     LoadStringstreamFromFile(f, ai.schema_path);
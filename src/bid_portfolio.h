@@ -1,6 +1,8 @@
 #ifndef CYCLUS_SRC_BID_PORTFOLIO_H_
 #define CYCLUS_SRC_BID_PORTFOLIO_H_
 
+#include <limits>
+#include <map>
 #include <set>
 #include <sstream>
 #include <string>
@@ -82,6 +84,38 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
                   std::numeric_limits<double>::quiet_NaN());
   }
 
+  /// @brief add n identical exclusive bids to the portfolio as a single
+  /// compact entry.  Only one Bid object is created and stored; the exchange
+  /// translator expands it into n exclusive bid nodes, each in its own
+  /// exclusive group, and trades on any of them refer back to the returned
+  /// bid.  This is how a seller offers n quanta of offer->quantity() without
+  /// creating a bid per quantum.
+  /// @param request the request being responded to by these bids
+  /// @param offer the resource offered by each of the bids
+  /// @param bidder the bidder
+  /// @param n the number of identical bids
+  /// @param preference sets the preference of the bids on a request
+  /// @throws ValueError if n is less than 1
+  Bid<T>* AddBids(Request<T>* request, boost::shared_ptr<T> offer,
+                  Trader* bidder, int n,
+                  double preference = std::numeric_limits<double>::quiet_NaN()) {
+    if (n < 1) {
+      throw ValueError("cannot add fewer than one bid");
+    }
+    Bid<T>* b = AddBid(request, offer, bidder, true, preference);
+    if (n > 1) {
+      copies_[b] = n;
+    }
+    return b;
+  }
+
+  /// @return the number of identical exclusive bids b stands for (see
+  /// AddBids), which is 1 for bids added with AddBid
+  inline int copies(Bid<T>* b) const {
+    typename std::map<Bid<T>*, int>::const_iterator it = copies_.find(b);
+    return it == copies_.end() ? 1 : it->second;
+  }
+
   /// @brief add a capacity constraint associated with the portfolio
   /// @param c the constraint to add
   inline void AddConstraint(const CapacityConstraint<T>& c) {
@@ -109,6 +143,7 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   BidPortfolio(const BidPortfolio& rhs) {
     bidder_ = rhs.bidder_;
     bids_ = rhs.bids_;
+    copies_ = rhs.copies_;
     constraints_ = rhs.constraints_;
     typename std::set<Bid<T>*>::iterator it;
     for (it = bids_.begin(); it != bids_.end(); ++it) {
@@ -137,6 +172,9 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   // bid and a request, i.e., bids are unique
   std::set<Bid<T>*> bids_;
 
+  // number of identical exclusive bids for bids standing for more than one
+  std::map<Bid<T>*, int> copies_;
+
   // constraints_ is a set because constraints are assumed to be unique
   std::set<CapacityConstraint<T>> constraints_;
 
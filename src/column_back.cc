@@ -0,0 +1,817 @@
+#include "column_back.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/serialization/list.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/set.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/uuid/uuid.hpp>
+
+#include "blob.h"
+#include "datum.h"
+#include "error.h"
+#include "logger.h"
+
+namespace fs = boost::filesystem;
+namespace bip = boost::interprocess;
+
+namespace cyclus {
+
+/// version of the on-disk layout, bumped whenever the manifest or column file
+/// format changes.
+static int const kColumnFormatVersion = 1;
+
+static std::string const kManifestName = "manifest";
+
+/// returns the byte width of a fixed width column type or 0 if values of the
+/// type are variable width.
+static int TypeWidth(DbTypes type) {
+  switch (type) {
+    case BOOL:
+      return 1;
+    case INT:
+      return sizeof(int);
+    case FLOAT:
+      return sizeof(float);
+    case DOUBLE:
+      return sizeof(double);
+    case UUID:
+      return CYCLUS_UUID_SIZE;
+    default:
+      return 0;
+  }
+}
+
+/// returns true if block statistics are kept for the column type.
+static bool HasStats(DbTypes type) {
+  return type == BOOL || type == INT || type == FLOAT || type == DOUBLE;
+}
+
+template <typename T>
+static void MinMax(const char* data, uint64_t n, double* min, double* max) {
+  const T* x = reinterpret_cast<const T*>(data);
+  T lo = x[0];
+  T hi = x[0];
+  for (uint64_t i = 1; i < n; ++i) {
+    lo = x[i] < lo ? x[i] : lo;
+    hi = x[i] > hi ? x[i] : hi;
+  }
+  *min = static_cast<double>(lo);
+  *max = static_cast<double>(hi);
+}
+
+/// ANDs the result of comparing every value in x with v into sel.  Each
+/// operator gets its own branch-free loop so the compiler can vectorize it.
+template <typename T>
+static void Select(const T* x, uint64_t n, CmpOpCode op, T v,
+                   unsigned char* sel) {
+  switch (op) {
+    case LT:
+      for (uint64_t i = 0; i < n; ++i) sel[i] &= x[i] < v;
+      break;
+    case GT:
+      for (uint64_t i = 0; i < n; ++i) sel[i] &= x[i] > v;
+      break;
+    case LE:
+      for (uint64_t i = 0; i < n; ++i) sel[i] &= x[i] <= v;
+      break;
+    case GE:
+      for (uint64_t i = 0; i < n; ++i) sel[i] &= x[i] >= v;
+      break;
+    case EQ:
+      for (uint64_t i = 0; i < n; ++i) sel[i] &= x[i] == v;
+      break;
+    case NE:
+      for (uint64_t i = 0; i < n; ++i) sel[i] &= x[i] != v;
+      break;
+  }
+}
+
+/// returns true if the result of a three-way comparison satisfies op.
+static bool CmpSign(int cmp, CmpOpCode op) {
+  switch (op) {
+    case LT:
+      return cmp < 0;
+    case GT:
+      return cmp > 0;
+    case LE:
+      return cmp <= 0;
+    case GE:
+      return cmp >= 0;
+    case EQ:
+      return cmp == 0;
+    case NE:
+      return cmp != 0;
+  }
+  return false;
+}
+
+/// returns true if no value in [min, max] can satisfy op against v.
+static bool Prune(double min, double max, CmpOpCode op, double v) {
+  switch (op) {
+    case LT:
+      return min >= v;
+    case GT:
+      return max <= v;
+    case LE:
+      return min > v;
+    case GE:
+      return max < v;
+    case EQ:
+      return v < min || v > max;
+    case NE:
+      return min == max && min == v;
+  }
+  return false;
+}
+
+/// returns the value of a numeric condition as a double.
+static double CondAsDouble(const Cond& c, DbTypes type) {
+  switch (type) {
+    case BOOL:
+      return c.val.cast<bool>();
+    case INT:
+      return c.val.cast<int>();
+    case FLOAT:
+      return c.val.cast<float>();
+    default:
+      return c.val.cast<double>();
+  }
+}
+
+static void AppendFile(const std::string& path, const char* data, size_t n) {
+  if (n == 0) {
+    return;
+  }
+  std::ofstream f(path.c_str(), std::ios::binary | std::ios::app);
+  f.write(data, n);
+  if (!f) {
+    throw IOError("failed to append to column file '" + path + "'");
+  }
+}
+
+typedef boost::shared_ptr<bip::mapped_region> RegionPtr;
+
+/// maps the first n bytes of the file at path read-only, returns an empty
+/// pointer if n is zero.
+static RegionPtr MapFile(const std::string& path, uint64_t n) {
+  if (n == 0) {
+    return RegionPtr();
+  }
+  try {
+    bip::file_mapping fm(path.c_str(), bip::read_only);
+    return RegionPtr(new bip::mapped_region(fm, bip::read_only, 0, n));
+  } catch (bip::interprocess_exception err) {
+    throw IOError("failed to map column file '" + path + "': " + err.what());
+  }
+}
+
+static const char* Addr(RegionPtr r) {
+  return r ? static_cast<const char*>(r->get_address()) : NULL;
+}
+
+ColumnBack::ColumnBack(std::string path, unsigned int block_rows)
+    : path_(path),
+      block_rows_(block_rows > 0 ? block_rows : 1) {
+  if (fs::exists(path_) && !fs::is_directory(path_)) {
+    throw IOError("column backend path '" + path_ + "' is not a directory");
+  }
+  fs::create_directories(path_);
+  LoadManifest();
+}
+
+ColumnBack::~ColumnBack() {
+  try {
+    Flush();
+  } catch (Error err) {
+    CLOG(LEV_ERROR) << "Error in ColumnBack destructor: " << err.what();
+  }
+}
+
+void ColumnBack::Notify(DatumList data) {
+  for (DatumList::iterator it = data.begin(); it != data.end(); ++it) {
+    if (tables_.count((*it)->title()) == 0) {
+      CreateTable(*it);
+    }
+    WriteDatum(*it);
+  }
+}
+
+std::string ColumnBack::Name() {
+  return path_;
+}
+
+void ColumnBack::Flush() {
+  std::map<std::string, Table>::iterator it;
+  for (it = tables_.begin(); it != tables_.end(); ++it) {
+    WriteBlock(it->first, it->second);
+  }
+  WriteManifest();
+}
+
+void ColumnBack::Close() {
+  Flush();
+}
+
+QueryResult ColumnBack::Query(std::string table, std::vector<Cond>* conds) {
+  if (tables_.count(table) == 0) {
+    throw ValueError("Invalid table name " + table);
+  }
+  Table& t = tables_[table];
+  WriteBlock(table, t);
+
+  QueryResult qr;
+  int ncols = t.cols.size();
+  std::map<std::string, int> idx;
+  for (int j = 0; j < ncols; ++j) {
+    qr.fields.push_back(t.cols[j].name);
+    qr.types.push_back(t.cols[j].type);
+    idx[t.cols[j].name] = j;
+  }
+
+  std::vector<std::vector<Cond*> > col_conds(ncols);
+  if (conds != NULL) {
+    for (int i = 0; i < conds->size(); ++i) {
+      Cond* c = &(*conds)[i];
+      if (idx.count(c->field) == 0) {
+        throw ValueError("condition on unknown field '" + c->field +
+                         "' in table '" + table + "'");
+      }
+      col_conds[idx[c->field]].push_back(c);
+    }
+  }
+
+  std::vector<RegionPtr> cols(ncols);
+  std::vector<RegionPtr> heaps(ncols);
+  for (int j = 0; j < ncols; ++j) {
+    Column& c = t.cols[j];
+    cols[j] = MapFile(ColPath(table, j, ".col"), c.col_size);
+    if (c.width == 0) {
+      heaps[j] = MapFile(ColPath(table, j, ".heap"), c.heap_size);
+    }
+  }
+
+  int nblocks = ncols > 0 ? t.cols[0].blocks.size() : 0;
+  std::vector<unsigned char> sel;
+  for (int b = 0; b < nblocks; ++b) {
+    uint64_t n = t.cols[0].blocks[b].nrows;
+    sel.assign(n, 1);
+
+    // cheap checks first - whole blocks are skipped using their statistics
+    // and constant columns are compared once for the entire block.
+    bool skip = false;
+    for (int j = 0; j < ncols && !skip; ++j) {
+      Column& c = t.cols[j];
+      const Block& blk = c.blocks[b];
+      for (int k = 0; k < col_conds[j].size() && !skip; ++k) {
+        Cond* cond = col_conds[j][k];
+        if (HasStats(c.type)) {
+          skip = Prune(blk.min, blk.max, cond->opcode,
+                       CondAsDouble(*cond, c.type));
+        } else if (c.type == UUID && blk.constant) {
+          boost::uuids::uuid v = cond->val.cast<boost::uuids::uuid>();
+          const char* x = Addr(cols[j]) + blk.offset;
+          skip = !CmpSign(memcmp(x, v.data, CYCLUS_UUID_SIZE), cond->opcode);
+        }
+      }
+    }
+    if (skip) {
+      continue;
+    }
+
+    // column-at-a-time filtering over the mapped arrays
+    for (int j = 0; j < ncols; ++j) {
+      Column& c = t.cols[j];
+      const Block& blk = c.blocks[b];
+      if (col_conds[j].empty() || blk.constant) {
+        continue;
+      }
+      const char* x = Addr(cols[j]) + blk.offset;
+      for (int k = 0; k < col_conds[j].size(); ++k) {
+        Cond* cond = col_conds[j][k];
+        switch (c.type) {
+          case BOOL: {
+            char v = cond->val.cast<bool>();
+            Select<char>(x, n, cond->opcode, v, &sel[0]);
+            break;
+          }
+          case INT: {
+            Select<int>(reinterpret_cast<const int*>(x), n, cond->opcode,
+                        cond->val.cast<int>(), &sel[0]);
+            break;
+          }
+          case FLOAT: {
+            Select<float>(reinterpret_cast<const float*>(x), n, cond->opcode,
+                          cond->val.cast<float>(), &sel[0]);
+            break;
+          }
+          case DOUBLE: {
+            Select<double>(reinterpret_cast<const double*>(x), n,
+                           cond->opcode, cond->val.cast<double>(), &sel[0]);
+            break;
+          }
+          case UUID: {
+            boost::uuids::uuid v = cond->val.cast<boost::uuids::uuid>();
+            for (uint64_t i = 0; i < n; ++i) {
+              sel[i] &= CmpSign(memcmp(x + i * CYCLUS_UUID_SIZE, v.data,
+                                       CYCLUS_UUID_SIZE), cond->opcode);
+            }
+            break;
+          }
+          case STRING: {
+            for (uint64_t i = 0; i < n; ++i) {
+              if (sel[i]) {
+                std::string v = ColAsVal(c, blk, i, Addr(cols[j]),
+                                         Addr(heaps[j])).cast<std::string>();
+                sel[i] = CmpCond<std::string>(&v, cond);
+              }
+            }
+            break;
+          }
+          case BLOB: {
+            for (uint64_t i = 0; i < n; ++i) {
+              if (sel[i]) {
+                Blob v = ColAsVal(c, blk, i, Addr(cols[j]),
+                                  Addr(heaps[j])).cast<Blob>();
+                sel[i] = CmpCond<Blob>(&v, cond);
+              }
+            }
+            break;
+          }
+          default: {
+            throw ValueError("conditions on column '" + c.name +
+                             "' in table '" + table + "' are not supported");
+          }
+        }
+      }
+    }
+
+    for (uint64_t i = 0; i < n; ++i) {
+      if (!sel[i]) {
+        continue;
+      }
+      QueryRow row(ncols);
+      for (int j = 0; j < ncols; ++j) {
+        row[j] = ColAsVal(t.cols[j], t.cols[j].blocks[b], i, Addr(cols[j]),
+                          Addr(heaps[j]));
+      }
+      qr.rows.push_back(row);
+    }
+  }
+  return qr;
+}
+
+std::map<std::string, DbTypes> ColumnBack::ColumnTypes(std::string table) {
+  if (tables_.count(table) == 0) {
+    throw ValueError("Invalid table name " + table);
+  }
+  std::map<std::string, DbTypes> rtn;
+  std::vector<Column>& cols = tables_[table].cols;
+  for (int i = 0; i < cols.size(); ++i) {
+    rtn[cols[i].name] = cols[i].type;
+  }
+  return rtn;
+}
+
+std::list<ColumnInfo> ColumnBack::Schema(std::string table) {
+  if (tables_.count(table) == 0) {
+    throw ValueError("Invalid table name " + table);
+  }
+  std::list<ColumnInfo> schema;
+  std::vector<Column>& cols = tables_[table].cols;
+  for (int i = 0; i < cols.size(); ++i) {
+    schema.push_back(ColumnInfo(table, cols[i].name, i, cols[i].type,
+                                std::vector<int>()));
+  }
+  return schema;
+}
+
+std::set<std::string> ColumnBack::Tables() {
+  std::set<std::string> rtn;
+  std::map<std::string, Table>::iterator it;
+  for (it = tables_.begin(); it != tables_.end(); ++it) {
+    rtn.insert(it->first);
+  }
+  return rtn;
+}
+
+void ColumnBack::CreateTable(Datum* d) {
+  Table& t = tables_[d->title()];
+  const Datum::Vals& vals = d->vals();
+  for (int i = 0; i < vals.size(); ++i) {
+    Column c;
+    c.name = vals[i].first;
+    c.type = DbTypeOf(vals[i].second);
+    c.width = TypeWidth(c.type);
+    t.cols.push_back(c);
+  }
+}
+
+void ColumnBack::WriteDatum(Datum* d) {
+  Table& t = tables_[d->title()];
+  const Datum::Vals& vals = d->vals();
+  if (vals.size() != t.cols.size()) {
+    std::stringstream ss;
+    ss << "datum for table '" << d->title() << "' has " << vals.size()
+       << " fields, expected " << t.cols.size();
+    throw ValueError(ss.str());
+  }
+
+// serializes the value v of type T and DbType D into the heap of column c
+// (inside a case statement)
+#define CYCLUS_COMMA ,
+#define CYCLUS_SAVEVAL(D, T) \
+    case D: { \
+    T x = v.cast<T>(); \
+    std::stringstream ss; \
+    { \
+      boost::archive::binary_oarchive ar(ss, boost::archive::no_header); \
+      ar & x; \
+    } \
+    c.heap += ss.str(); \
+    break; \
+    }
+
+  for (int i = 0; i < vals.size(); ++i) {
+    Column& c = t.cols[i];
+    const boost::spirit::hold_any& v = vals[i].second;
+    switch (c.type) {
+      case BOOL: {
+        c.buf.push_back(static_cast<char>(v.cast<bool>()));
+        break;
+      }
+      case INT: {
+        int x = v.cast<int>();
+        const char* p = reinterpret_cast<const char*>(&x);
+        c.buf.insert(c.buf.end(), p, p + sizeof(x));
+        break;
+      }
+      case FLOAT: {
+        float x = v.cast<float>();
+        const char* p = reinterpret_cast<const char*>(&x);
+        c.buf.insert(c.buf.end(), p, p + sizeof(x));
+        break;
+      }
+      case DOUBLE: {
+        double x = v.cast<double>();
+        const char* p = reinterpret_cast<const char*>(&x);
+        c.buf.insert(c.buf.end(), p, p + sizeof(x));
+        break;
+      }
+      case UUID: {
+        boost::uuids::uuid x = v.cast<boost::uuids::uuid>();
+        c.buf.insert(c.buf.end(), x.data, x.data + CYCLUS_UUID_SIZE);
+        break;
+      }
+      case STRING: {
+        c.heap += v.cast<std::string>();
+        break;
+      }
+      case BLOB: {
+        c.heap += v.cast<Blob>().str();
+        break;
+      }
+      CYCLUS_SAVEVAL(SET_INT, std::set<int>);
+      CYCLUS_SAVEVAL(SET_STRING, std::set<std::string>);
+      CYCLUS_SAVEVAL(LIST_INT, std::list<int>);
+      CYCLUS_SAVEVAL(LIST_STRING, std::list<std::string>);
+      CYCLUS_SAVEVAL(VECTOR_INT, std::vector<int>);
+      CYCLUS_SAVEVAL(VECTOR_DOUBLE, std::vector<double>);
+      CYCLUS_SAVEVAL(VECTOR_STRING, std::vector<std::string>);
+      CYCLUS_SAVEVAL(MAP_INT_DOUBLE, std::map<int CYCLUS_COMMA double>);
+      CYCLUS_SAVEVAL(MAP_INT_INT, std::map<int CYCLUS_COMMA int>);
+      CYCLUS_SAVEVAL(MAP_INT_STRING, std::map<int CYCLUS_COMMA std::string>);
+      CYCLUS_SAVEVAL(MAP_STRING_INT, std::map<std::string CYCLUS_COMMA int>);
+      CYCLUS_SAVEVAL(MAP_STRING_DOUBLE,
+                     std::map<std::string CYCLUS_COMMA double>);
+      CYCLUS_SAVEVAL(MAP_STRING_STRING,
+                     std::map<std::string CYCLUS_COMMA std::string>);
+      CYCLUS_SAVEVAL(MAP_STRING_VECTOR_DOUBLE,
+                     std::map<std::string CYCLUS_COMMA std::vector<double> >);
+      CYCLUS_SAVEVAL(
+          MAP_STRING_MAP_INT_DOUBLE,
+          std::map<std::string CYCLUS_COMMA std::map<int CYCLUS_COMMA double> >);
+      CYCLUS_SAVEVAL(
+          MAP_STRING_PAIR_DOUBLE_MAP_INT_DOUBLE,
+          std::map<std::string CYCLUS_COMMA std::pair<
+              double CYCLUS_COMMA std::map<int CYCLUS_COMMA double> > >);
+      CYCLUS_SAVEVAL(MAP_INT_MAP_STRING_DOUBLE,
+                     std::map<int CYCLUS_COMMA
+                              std::map<std::string CYCLUS_COMMA double> >);
+      CYCLUS_SAVEVAL(
+          MAP_STRING_VECTOR_PAIR_INT_PAIR_STRING_STRING,
+          std::map<std::string CYCLUS_COMMA
+          std::vector<std::pair<int CYCLUS_COMMA
+          std::pair<std::string CYCLUS_COMMA std::string> > > >);
+      CYCLUS_SAVEVAL(
+          MAP_STRING_PAIR_STRING_VECTOR_DOUBLE,
+          std::map<std::string CYCLUS_COMMA
+          std::pair<std::string CYCLUS_COMMA std::vector<double> > >);
+      CYCLUS_SAVEVAL(LIST_PAIR_INT_INT,
+                     std::list<std::pair<int CYCLUS_COMMA int> >);
+      CYCLUS_SAVEVAL(
+          MAP_STRING_MAP_STRING_INT,
+          std::map<std::string CYCLUS_COMMA
+                   std::map<std::string CYCLUS_COMMA int> >);
+      CYCLUS_SAVEVAL(
+          VECTOR_PAIR_PAIR_DOUBLE_DOUBLE_MAP_STRING_DOUBLE,
+          std::vector<std::pair<
+              std::pair<double CYCLUS_COMMA double> CYCLUS_COMMA
+              std::map<std::string CYCLUS_COMMA double> > >);
+      default: {
+        throw ValueError("attempted to record unsupported column backend type");
+      }
+    }
+    if (c.width == 0) {
+      uint64_t end = c.heap_size + c.heap.size();
+      const char* p = reinterpret_cast<const char*>(&end);
+      c.buf.insert(c.buf.end(), p, p + sizeof(end));
+    }
+  }
+#undef CYCLUS_SAVEVAL
+#undef CYCLUS_COMMA
+
+  t.npending++;
+  if (t.npending >= block_rows_) {
+    WriteBlock(d->title(), t);
+  }
+}
+
+void ColumnBack::WriteBlock(const std::string& name, Table& t) {
+  if (t.npending == 0) {
+    return;
+  }
+
+  for (int j = 0; j < t.cols.size(); ++j) {
+    Column& c = t.cols[j];
+    Block b;
+    b.nrows = t.npending;
+    b.offset = c.col_size;
+    b.nbytes = c.buf.size();
+    const char* data = &c.buf[0];
+
+    if (c.width > 0) {
+      b.constant = true;
+      for (uint64_t i = 1; i < b.nrows && b.constant; ++i) {
+        b.constant = memcmp(data, data + i * c.width, c.width) == 0;
+      }
+      if (b.constant) {
+        b.nbytes = c.width;
+      }
+    } else {
+      b.heap_offset = c.heap_size;
+      AppendFile(ColPath(name, j, ".heap"), c.heap.c_str(), c.heap.size());
+      c.heap_size += c.heap.size();
+      c.heap.clear();
+    }
+
+    uint64_t nstat = b.constant ? 1 : b.nrows;
+    switch (c.type) {
+      case BOOL:
+        MinMax<char>(data, nstat, &b.min, &b.max);
+        break;
+      case INT:
+        MinMax<int>(data, nstat, &b.min, &b.max);
+        break;
+      case FLOAT:
+        MinMax<float>(data, nstat, &b.min, &b.max);
+        break;
+      case DOUBLE:
+        MinMax<double>(data, nstat, &b.min, &b.max);
+        break;
+      default:
+        break;
+    }
+
+    AppendFile(ColPath(name, j, ".col"), data, b.nbytes);
+    c.col_size += b.nbytes;
+    c.blocks.push_back(b);
+    c.buf.clear();
+  }
+  t.nrows += t.npending;
+  t.npending = 0;
+}
+
+void ColumnBack::WriteManifest() {
+  std::string path = (fs::path(path_) / kManifestName).string();
+  std::string tmp = path + ".tmp";
+  std::ofstream f(tmp.c_str());
+  f << std::setprecision(17);
+  f << "cyclus-columns " << kColumnFormatVersion << "\n";
+
+  std::map<std::string, Table>::iterator it;
+  for (it = tables_.begin(); it != tables_.end(); ++it) {
+    Table& t = it->second;
+    f << "table " << it->first << " " << t.nrows << " " << t.cols.size()
+      << "\n";
+    for (int j = 0; j < t.cols.size(); ++j) {
+      Column& c = t.cols[j];
+      f << "column " << c.name << " " << c.type << " " << c.blocks.size()
+        << " " << c.col_size << " " << c.heap_size << "\n";
+      for (int k = 0; k < c.blocks.size(); ++k) {
+        Block& b = c.blocks[k];
+        f << "block " << b.nrows << " " << b.offset << " " << b.nbytes << " "
+          << b.heap_offset << " " << b.constant << " " << b.min << " "
+          << b.max << "\n";
+      }
+    }
+  }
+  f.close();
+  if (!f) {
+    throw IOError("failed to write column manifest '" + tmp + "'");
+  }
+  fs::rename(tmp, path);
+}
+
+void ColumnBack::LoadManifest() {
+  std::string path = (fs::path(path_) / kManifestName).string();
+  if (!fs::exists(path)) {
+    return;
+  }
+
+  std::ifstream f(path.c_str());
+  std::string tag;
+  int version = 0;
+  f >> tag >> version;
+  if (tag != "cyclus-columns" || version != kColumnFormatVersion) {
+    throw IOError("'" + path + "' is not a supported column manifest");
+  }
+
+  std::string name;
+  int ncols;
+  while (f >> tag >> name) {
+    Table& t = tables_[name];
+    f >> t.nrows >> ncols;
+    t.cols.resize(ncols);
+    for (int j = 0; j < ncols; ++j) {
+      Column& c = t.cols[j];
+      int type;
+      int nblocks;
+      f >> tag >> c.name >> type >> nblocks >> c.col_size >> c.heap_size;
+      c.type = static_cast<DbTypes>(type);
+      c.width = TypeWidth(c.type);
+      c.blocks.resize(nblocks);
+      for (int k = 0; k < nblocks; ++k) {
+        Block& b = c.blocks[k];
+        f >> tag >> b.nrows >> b.offset >> b.nbytes >> b.heap_offset
+          >> b.constant >> b.min >> b.max;
+      }
+
+      // drop anything appended after the manifest was last written (e.g. by
+      // a run that died between a block write and a flush).
+      std::string col = ColPath(name, j, ".col");
+      if (fs::exists(col) && fs::file_size(col) > c.col_size) {
+        fs::resize_file(col, c.col_size);
+      }
+      std::string heap = ColPath(name, j, ".heap");
+      if (fs::exists(heap) && fs::file_size(heap) > c.heap_size) {
+        fs::resize_file(heap, c.heap_size);
+      }
+    }
+    if (!f) {
+      throw IOError("corrupt column manifest '" + path + "'");
+    }
+  }
+}
+
+std::string ColumnBack::ColPath(const std::string& table, int col,
+                                const char* ext) {
+  std::stringstream ss;
+  ss << table << "." << col << ext;
+  return (fs::path(path_) / ss.str()).string();
+}
+
+boost::spirit::hold_any ColumnBack::ColAsVal(const Column& c, const Block& b,
+                                             uint64_t row, const char* col,
+                                             const char* heap) {
+  boost::spirit::hold_any v;
+  const char* x = NULL;
+  uint64_t n = 0;
+  if (c.width > 0) {
+    x = col + b.offset + (b.constant ? 0 : row * c.width);
+  } else {
+    const uint64_t* ends = reinterpret_cast<const uint64_t*>(col + b.offset);
+    uint64_t begin = row == 0 ? b.heap_offset : ends[row - 1];
+    x = heap + begin;
+    n = ends[row] - begin;
+  }
+
+// reconstructs a value of type T and DbType D from its serialization in the
+// heap and stores it in v.
+#define CYCLUS_COMMA ,
+#define CYCLUS_LOADVAL(D, T) \
+    case D: { \
+    std::stringstream ss(std::string(x, n)); \
+    boost::archive::binary_iarchive ar(ss, boost::archive::no_header); \
+    T vect; \
+    ar & vect; \
+    v = vect; \
+    break; \
+    }
+
+  switch (c.type) {
+    case BOOL: {
+      v = static_cast<bool>(*x);
+      break;
+    }
+    case INT: {
+      int i;
+      memcpy(&i, x, sizeof(i));
+      v = i;
+      break;
+    }
+    case FLOAT: {
+      float f;
+      memcpy(&f, x, sizeof(f));
+      v = f;
+      break;
+    }
+    case DOUBLE: {
+      double d;
+      memcpy(&d, x, sizeof(d));
+      v = d;
+      break;
+    }
+    case UUID: {
+      boost::uuids::uuid u;
+      memcpy(&u, x, CYCLUS_UUID_SIZE);
+      v = u;
+      break;
+    }
+    case STRING: {
+      v = std::string(x, n);
+      break;
+    }
+    case BLOB: {
+      v = Blob(std::string(x, n));
+      break;
+    }
+    CYCLUS_LOADVAL(SET_INT, std::set<int>);
+    CYCLUS_LOADVAL(SET_STRING, std::set<std::string>);
+    CYCLUS_LOADVAL(LIST_INT, std::list<int>);
+    CYCLUS_LOADVAL(LIST_STRING, std::list<std::string>);
+    CYCLUS_LOADVAL(VECTOR_INT, std::vector<int>);
+    CYCLUS_LOADVAL(VECTOR_DOUBLE, std::vector<double>);
+    CYCLUS_LOADVAL(VECTOR_STRING, std::vector<std::string>);
+    CYCLUS_LOADVAL(MAP_INT_DOUBLE, std::map<int CYCLUS_COMMA double>);
+    CYCLUS_LOADVAL(MAP_INT_INT, std::map<int CYCLUS_COMMA int>);
+    CYCLUS_LOADVAL(MAP_INT_STRING, std::map<int CYCLUS_COMMA std::string>);
+    CYCLUS_LOADVAL(MAP_STRING_INT, std::map<std::string CYCLUS_COMMA int>);
+    CYCLUS_LOADVAL(MAP_STRING_DOUBLE,
+                   std::map<std::string CYCLUS_COMMA double>);
+    CYCLUS_LOADVAL(MAP_STRING_STRING,
+                   std::map<std::string CYCLUS_COMMA std::string>);
+    CYCLUS_LOADVAL(MAP_STRING_VECTOR_DOUBLE,
+                   std::map<std::string CYCLUS_COMMA std::vector<double> >);
+    CYCLUS_LOADVAL(
+        MAP_STRING_MAP_INT_DOUBLE,
+        std::map<std::string CYCLUS_COMMA std::map<int CYCLUS_COMMA double> >);
+    CYCLUS_LOADVAL(
+        MAP_STRING_PAIR_DOUBLE_MAP_INT_DOUBLE,
+        std::map<std::string CYCLUS_COMMA std::pair<
+            double CYCLUS_COMMA std::map<int CYCLUS_COMMA double> > >);
+    CYCLUS_LOADVAL(MAP_INT_MAP_STRING_DOUBLE,
+                   std::map<int CYCLUS_COMMA
+                            std::map<std::string CYCLUS_COMMA double> >);
+    CYCLUS_LOADVAL(
+        MAP_STRING_VECTOR_PAIR_INT_PAIR_STRING_STRING,
+        std::map<std::string CYCLUS_COMMA
+        std::vector<std::pair<int CYCLUS_COMMA
+        std::pair<std::string CYCLUS_COMMA std::string> > > >);
+    CYCLUS_LOADVAL(
+        MAP_STRING_PAIR_STRING_VECTOR_DOUBLE,
+        std::map<std::string CYCLUS_COMMA
+        std::pair<std::string CYCLUS_COMMA std::vector<double> > >);
+    CYCLUS_LOADVAL(LIST_PAIR_INT_INT,
+                   std::list<std::pair<int CYCLUS_COMMA int> >);
+    CYCLUS_LOADVAL(
+        MAP_STRING_MAP_STRING_INT,
+        std::map<std::string CYCLUS_COMMA
+                 std::map<std::string CYCLUS_COMMA int> >);
+    CYCLUS_LOADVAL(
+        VECTOR_PAIR_PAIR_DOUBLE_DOUBLE_MAP_STRING_DOUBLE,
+        std::vector<std::pair<
+            std::pair<double CYCLUS_COMMA double> CYCLUS_COMMA
+            std::map<std::string CYCLUS_COMMA double> > >);
+    default: {
+      throw ValueError("attempted to retrieve unsupported column backend type");
+    }
+  }
+#undef CYCLUS_LOADVAL
+#undef CYCLUS_COMMA
+
+  return v;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,179 @@
+#ifndef CYCLUS_SRC_COLUMN_BACK_H_
+#define CYCLUS_SRC_COLUMN_BACK_H_
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "query_backend.h"
+
+namespace cyclus {
+
+/// default number of rows buffered per table before a block is appended to
+/// the column files.
+static unsigned int const kDefaultBlockRows = 65536;
+
+/// A Recorder backend that stores each table as a set of append-only typed
+/// column files inside a directory.  Rows are buffered per table and written
+/// out in large blocks, one file per column.  Fixed width values (int, bool,
+/// float, double, uuid) are stored as raw arrays; all other values are stored
+/// as an array of end offsets into a per-column heap file.  A small text
+/// manifest records the schema of every table along with per-block row
+/// counts and min/max statistics.  Blocks whose values are all identical
+/// (e.g. the SimId column) are stored as a single value.
+///
+/// Queries memory-map the column files, skip blocks whose statistics cannot
+/// satisfy the conditions and then filter the remaining blocks one column at
+/// a time before materializing the selected rows.
+///
+/// Example usage:
+///
+/// @code
+///
+/// ColumnBack* back = new ColumnBack("output.cyc");
+/// rec.RegisterBackend(back);
+/// ...
+/// rec.Close();
+/// QueryResult qr = back->Query("Resources", NULL);
+///
+/// @endcode
+class ColumnBack: public FullBackend {
+ public:
+  /// Creates a new column backend that writes to the directory specified by
+  /// path.  If the directory already contains column tables, their manifest is
+  /// loaded and new rows are appended to them.
+  /// @param path the directory to write the column files to.
+  /// @param block_rows number of rows per table to buffer before appending a
+  /// block to the column files.
+  ColumnBack(std::string path, unsigned int block_rows = kDefaultBlockRows);
+
+  virtual ~ColumnBack();
+
+  /// Buffers Datum objects, appending a block to a table's column files
+  /// whenever block_rows rows have been collected for it.
+  virtual void Notify(DatumList data);
+
+  /// Returns a unique name for this backend.
+  virtual std::string Name();
+
+  /// Appends all buffered rows to the column files and rewrites the manifest.
+  virtual void Flush();
+
+  /// Flushes the backend.
+  virtual void Close();
+
+  virtual QueryResult Query(std::string table, std::vector<Cond>* conds);
+
+  virtual std::map<std::string, DbTypes> ColumnTypes(std::string table);
+
+  virtual std::list<ColumnInfo> Schema(std::string table);
+
+  virtual std::set<std::string> Tables();
+
+ private:
+  /// A contiguous run of rows written to a column file in a single append.
+  struct Block {
+    Block()
+        : nrows(0),
+          offset(0),
+          nbytes(0),
+          heap_offset(0),
+          constant(false),
+          min(0),
+          max(0) {}
+
+    uint64_t nrows;
+
+    /// byte offset of the block in the column file.
+    uint64_t offset;
+
+    /// number of bytes the block occupies in the column file.
+    uint64_t nbytes;
+
+    /// byte offset in the heap file of the block's first value (variable
+    /// width columns only).
+    uint64_t heap_offset;
+
+    /// true if every row in the block holds the same value and only that
+    /// value was written.
+    bool constant;
+
+    /// value range of the block (numeric columns only).
+    double min;
+    double max;
+  };
+
+  struct Column {
+    Column() : type(INT), width(0), col_size(0), heap_size(0) {}
+
+    std::string name;
+    DbTypes type;
+
+    /// byte width of a value, 0 for variable width columns.
+    int width;
+
+    /// pending fixed width values or variable width end offsets.
+    std::vector<char> buf;
+
+    /// pending variable width value bytes.
+    std::string heap;
+
+    /// number of bytes already appended to the column and heap files.
+    uint64_t col_size;
+    uint64_t heap_size;
+
+    std::vector<Block> blocks;
+  };
+
+  struct Table {
+    Table() : nrows(0), npending(0) {}
+
+    std::vector<Column> cols;
+
+    /// number of rows already appended to the column files.
+    uint64_t nrows;
+
+    /// number of rows buffered in memory.
+    unsigned int npending;
+  };
+
+  /// Initializes an empty table with the schema of d.
+  void CreateTable(Datum* d);
+
+  /// Adds the values of d to the buffers of its table.
+  void WriteDatum(Datum* d);
+
+  /// Appends the buffered rows of a table to its column files as one block.
+  void WriteBlock(const std::string& name, Table& t);
+
+  /// Writes the manifest describing all tables and blocks.
+  void WriteManifest();
+
+  /// Loads the manifest of a previously written directory, if there is one.
+  void LoadManifest();
+
+  /// returns the path of a column's data (ext ".col") or heap (ext ".heap")
+  /// file.
+  std::string ColPath(const std::string& table, int col, const char* ext);
+
+  /// returns the value at row of block b in column c, where col and heap are
+  /// the mapped column and heap files.
+  boost::spirit::hold_any ColAsVal(const Column& c, const Block& b,
+                                   uint64_t row, const char* col,
+                                   const char* heap);
+
+  /// Stores the directory path, declared during construction.
+  std::string path_;
+
+  unsigned int block_rows_;
+
+  std::map<std::string, Table> tables_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_COLUMN_BACK_H_
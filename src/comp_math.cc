@@ -1,7 +1,9 @@
 #include "comp_math.h"
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
+#include <utility>
 
 #include "cyc_arithmetic.h"
 #include "error.h"
@@ -15,6 +17,73 @@
 namespace cyclus {
 namespace compmath {
 
+static bool NucLess(const std::pair<Nuc, double>& a,
+                    const std::pair<Nuc, double>& b) {
+  return a.first < b.first;
+}
+
+/// Returns v1 + a * v2 for sorted nuclide arrays in a single merge pass.
+static CompVec Merge(const CompVec& v1, double a1, const CompVec& v2,
+                     double a2) {
+  const std::vector<Nuc>& n1 = v1.nucs();
+  const std::vector<Nuc>& n2 = v2.nucs();
+  const std::vector<double>& q1 = v1.vals();
+  const std::vector<double>& q2 = v2.vals();
+  int s1 = n1.size();
+  int s2 = n2.size();
+
+  CompVec out;
+  out.reserve(s1 + s2);
+  int i = 0;
+  int j = 0;
+  while (i < s1 && j < s2) {
+    if (n1[i] < n2[j]) {
+      out.Append(n1[i], a1 * q1[i]);
+      ++i;
+    } else if (n2[j] < n1[i]) {
+      out.Append(n2[j], 0 + a2 * q2[j]);
+      ++j;
+    } else {
+      out.Append(n1[i], a1 * q1[i] + a2 * q2[j]);
+      ++i;
+      ++j;
+    }
+  }
+  for (; i < s1; ++i) {
+    out.Append(n1[i], a1 * q1[i]);
+  }
+  for (; j < s2; ++j) {
+    out.Append(n2[j], 0 + a2 * q2[j]);
+  }
+  return out;
+}
+
+/// Throws a ValueError if threshold is negative.
+static void CheckThreshold(double threshold) {
+  if (threshold < 0) {
+    std::stringstream ss;
+    ss << "The threshold cannot be negative. The value provided was '"
+       << threshold << "'.";
+    throw ValueError(ss.str());
+  }
+}
+
+/// Returns true if the nuclide quantities x and y are the same within
+/// threshold.
+static bool AlmostEqVal(double x, double y, double threshold) {
+  // I learned at
+  // http://www.ualberta.ca/~kbeach/comp_phys/fp_err.html#testing-for-equality
+  // that the following is less naive than the intuitive way of doing this...
+  // almost equal if :
+  // (abs(x-y) < abs(x)*eps) && (abs(x-y) < abs(y)*epsilon)
+  double diff = y - x;
+  if (std::abs(y) == 0 || std::abs(x) == 0) {
+    return !(std::abs(diff) > std::abs(diff) * threshold);
+  }
+  return !(std::abs(diff) > std::abs(y) * threshold ||
+           std::abs(diff) > std::abs(x) * threshold);
+}
+
 CompMap Add(const CompMap& v1, const CompMap& v2) {
   CompMap out(v1);
   for (CompMap::const_iterator it = v2.begin(); it != v2.end(); ++it) {
@@ -43,12 +112,7 @@ double Sum(const CompMap& v) {
 }
 
 void ApplyThreshold(CompMap* v, double threshold) {
-  if (threshold < 0) {
-    std::stringstream ss;
-    ss << "The threshold cannot be negative. The value provided was '"
-       << threshold << "'.";
-    throw ValueError(ss.str());
-  }
+  CheckThreshold(threshold);
 
   CompMap::iterator it = v->begin();
   while (it != v->end()) {
@@ -91,17 +155,7 @@ bool AllPositive(const CompMap& v) {
 }
 
 bool AlmostEq(const CompMap& v1, const CompMap& v2, double threshold) {
-  // I learned at
-  // http://www.ualberta.ca/~kbeach/comp_phys/fp_err.html#testing-for-equality
-  // that the following is less naive than the intuitive way of doing this...
-  // almost equal if :
-  // (abs(x-y) < abs(x)*eps) && (abs(x-y) < abs(y)*epsilon)
-  if (threshold < 0) {
-    std::stringstream ss;
-    ss << "The threshold cannot be negative. The value provided was '"
-       << threshold << "'.";
-    throw ValueError(ss.str());
-  }
+  CheckThreshold(threshold);
 
   if (v1.size() != v2.size()) {
     return false;
@@ -118,15 +172,135 @@ bool AlmostEq(const CompMap& v1, const CompMap& v2, double threshold) {
     if (n2.count(nuc) == 0) {
       return false;
     }
-    double minuend = n2[nuc];
-    double subtrahend = n1[nuc];
-    double diff = minuend - subtrahend;
-    if (std::abs(minuend) == 0 || std::abs(subtrahend) == 0) {
-      if (std::abs(diff) > std::abs(diff)*threshold) {
-        return false;
-      }
-    } else if (std::abs(diff) > std::abs(minuend)*threshold ||
-               std::abs(diff) > std::abs(subtrahend)*threshold) {
+    if (!AlmostEqVal(n1[nuc], n2[nuc], threshold)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CompVec Add(const CompVec& v1, const CompVec& v2) {
+  return Merge(v1, 1.0, v2, 1.0);
+}
+
+CompVec Sub(const CompVec& v1, const CompVec& v2) {
+  return Merge(v1, 1.0, v2, -1.0);
+}
+
+/// Returns the factor Normalize(v, val) scales v's quantities by.
+static double NormFactor(const CompVec& v, double val) {
+  double sum = Sum(v);
+  if (sum != val && sum != 0) {
+    return val / sum;
+  }
+  return 1;
+}
+
+CompVec Mix(const CompVec& v1, double qty1, const CompVec& v2, double qty2) {
+  return Merge(v1, NormFactor(v1, qty1), v2, NormFactor(v2, qty2));
+}
+
+CompVec Mix(const std::vector<const CompVec*>& vs,
+            const std::vector<double>& qtys) {
+  if (vs.size() != qtys.size()) {
+    throw ValueError("Mix needs one quantity per composition");
+  } else if (vs.size() == 2) {
+    return Mix(*vs[0], qtys[0], *vs[1], qtys[1]);
+  }
+
+  int n = 0;
+  for (int k = 0; k < vs.size(); ++k) {
+    n += vs[k]->size();
+  }
+
+  // gather every scaled entry, then stable sort by nuclide so each
+  // nuclide's contributions stay in input order when they are summed
+  std::vector<std::pair<Nuc, double> > all;
+  all.reserve(n);
+  for (int k = 0; k < vs.size(); ++k) {
+    double a = NormFactor(*vs[k], qtys[k]);
+    const std::vector<Nuc>& nucs = vs[k]->nucs();
+    const std::vector<double>& vals = vs[k]->vals();
+    for (int i = 0; i < nucs.size(); ++i) {
+      all.push_back(std::make_pair(nucs[i], a * vals[i]));
+    }
+  }
+  std::stable_sort(all.begin(), all.end(), NucLess);
+
+  CompVec out;
+  out.reserve(all.size());
+  for (int i = 0; i < all.size();) {
+    Nuc nuc = all[i].first;
+    double val = all[i].second;
+    for (++i; i < all.size() && all[i].first == nuc; ++i) {
+      val += all[i].second;
+    }
+    out.Append(nuc, val);
+  }
+  return out;
+}
+
+double Sum(const CompVec& v) {
+  return CycArithmetic::KahanSum(v.vals());
+}
+
+void ApplyThreshold(CompVec* v, double threshold) {
+  CheckThreshold(threshold);
+
+  const std::vector<Nuc>& nucs = v->nucs();
+  const std::vector<double>& vals = v->vals();
+  CompVec out;
+  out.reserve(v->size());
+  for (int i = 0; i < nucs.size(); ++i) {
+    if (std::abs(vals[i]) > threshold) {
+      out.Append(nucs[i], vals[i]);
+    }
+  }
+  *v = out;
+}
+
+void Normalize(CompVec* v, double val) {
+  double mult = NormFactor(*v, val);
+  if (mult != 1) {
+    std::vector<double>& vals = v->vals();
+    double* q = vals.empty() ? NULL : &vals[0];
+    int n = vals.size();
+    for (int i = 0; i < n; ++i) {
+      q[i] *= mult;
+    }
+  }
+}
+
+bool ValidNucs(const CompVec& v) {
+  const std::vector<Nuc>& nucs = v.nucs();
+  for (int i = 0; i < nucs.size(); ++i) {
+    if (!pyne::nucname::isnuclide(nucs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AllPositive(const CompVec& v) {
+  const std::vector<double>& vals = v.vals();
+  for (int i = 0; i < vals.size(); ++i) {
+    if (vals[i] < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AlmostEq(const CompVec& v1, const CompVec& v2, double threshold) {
+  CheckThreshold(threshold);
+
+  if (v1.nucs() != v2.nucs()) {
+    return false;
+  }
+  const std::vector<double>& q1 = v1.vals();
+  const std::vector<double>& q2 = v2.vals();
+  for (int i = 0; i < q1.size(); ++i) {
+    if (!AlmostEqVal(q1[i], q2[i], threshold)) {
       return false;
     }
   }
@@ -49,6 +49,32 @@ bool AllPositive(const CompMap& v);
 /// normalization is performed.
 bool AlmostEq(const CompMap& v1, const CompMap& v2, double threshold);
 
+/// CompVec versions of the functions above.  Add and Sub merge the two sorted
+/// nuclide arrays in a single pass.  Results are identical to those of the
+/// CompMap versions.
+CompVec Add(const CompVec& v1, const CompVec& v2);
+CompVec Sub(const CompVec& v1, const CompVec& v2);
+double Sum(const CompVec& v);
+void ApplyThreshold(CompVec* v, double threshold);
+void Normalize(CompVec* v, double val = 1.0);
+bool ValidNucs(const CompVec& v);
+bool AllPositive(const CompVec& v);
+bool AlmostEq(const CompVec& v1, const CompVec& v2, double threshold);
+
+/// Returns v1 normalized to qty1 plus v2 normalized to qty2, computed in a
+/// single merge pass without normalized copies of either input.  The result
+/// is identical to normalizing copies of v1 and v2 and adding them.  A
+/// negative qty2 subtracts v2, as when extracting material.
+CompVec Mix(const CompVec& v1, double qty1, const CompVec& v2, double qty2);
+
+/// Returns the sum of every vs[i] normalized to qtys[i], computed in one pass
+/// over all of their nuclides.  Each nuclide's contributions are added in
+/// the order of vs, so the result matches mixing the inputs in pairs up to
+/// rounding, without the intermediate compositions.
+/// Throws a ValueError if vs and qtys differ in size.
+CompVec Mix(const std::vector<const CompVec*>& vs,
+            const std::vector<double>& qtys);
+
 }  // namespace compmath
 }  // namespace cyclus
 
@@ -1,15 +1,51 @@
 #include "composition.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include <boost/functional/hash.hpp>
+
 #include "comp_math.h"
 #include "context.h"
+#include "decay_op.h"
 #include "decayer.h"
 #include "error.h"
+#include "nuc_data.h"
 #include "recorder.h"
-#include "pyne_decay.h"
 
 namespace cyclus {
 
-int Composition::next_id_ = 1;
+IdAllocator Composition::next_id_(1);
+
+/// Number of mantissa bits of normalized quantities that are compared when
+/// interning compositions; quantities closer than about 1e-11 relative are
+/// considered equal.
+static const int kInternBits = 36;
+
+CompVec::CompVec(const CompMap& m) {
+  reserve(m.size());
+  for (CompMap::const_iterator it = m.begin(); it != m.end(); ++it) {
+    Append(it->first, it->second);
+  }
+}
+
+CompMap CompVec::ToMap() const {
+  CompMap m;
+  for (int i = 0; i < nucs_.size(); ++i) {
+    // nuclides are sorted, so each insert is amortized constant time
+    m.insert(m.end(), std::make_pair(nucs_[i], vals_[i]));
+  }
+  return m;
+}
+
+double CompVec::Get(Nuc nuc) const {
+  std::vector<Nuc>::const_iterator it =
+      std::lower_bound(nucs_.begin(), nucs_.end(), nuc);
+  if (it == nucs_.end() || *it != nuc) {
+    return 0;
+  }
+  return vals_[it - nucs_.begin()];
+}
 
 Composition::Ptr Composition::CreateFromAtom(CompMap v) {
   if (!compmath::ValidNucs(v))
@@ -18,8 +54,13 @@ Composition::Ptr Composition::CreateFromAtom(CompMap v) {
   if (!compmath::AllPositive(v))
     throw ValueError("negative quantity in CompMap");
 
-  Composition::Ptr c(new Composition());
-  c->atom_ = v;
+  std::size_t hash;
+  Composition::Ptr c = Lookup(CompVec(v), ATOM_BASIS, &hash);
+  if (c == NULL) {
+    c = Composition::Ptr(new Composition());
+    c->atom_ = v;
+    Register(c.get(), ATOM_BASIS, hash);
+  }
   return c;
 }
 
@@ -30,8 +71,31 @@ Composition::Ptr Composition::CreateFromMass(CompMap v) {
   if (!compmath::AllPositive(v))
     throw ValueError("negative quantity in CompMap");
 
-  Composition::Ptr c(new Composition());
-  c->mass_ = v;
+  std::size_t hash;
+  Composition::Ptr c = Lookup(CompVec(v), MASS_BASIS, &hash);
+  if (c == NULL) {
+    c = Composition::Ptr(new Composition());
+    c->mass_ = v;
+    Register(c.get(), MASS_BASIS, hash);
+  }
+  return c;
+}
+
+Composition::Ptr Composition::CreateFromMass(const CompVec& v) {
+  if (!compmath::ValidNucs(v))
+    throw ValueError("invalid nuclide in CompVec");
+
+  if (!compmath::AllPositive(v))
+    throw ValueError("negative quantity in CompVec");
+
+  std::size_t hash;
+  Composition::Ptr c = Lookup(v, MASS_BASIS, &hash);
+  if (c == NULL) {
+    c = Composition::Ptr(new Composition());
+    c->mass_ = v.ToMap();
+    c->mass_vec_ = v;
+    Register(c.get(), MASS_BASIS, hash);
+  }
   return c;
 }
 
@@ -44,7 +108,7 @@ const CompMap& Composition::atom() {
     CompMap::iterator it;
     for (it = mass_.begin(); it != mass_.end(); ++it) {
       Nuc nuc = it->first;
-      atom_[nuc] = it->second / pyne::atomic_mass(nuc);
+      atom_[nuc] = it->second / NucData::atomic_mass(nuc);
     }
   }
   return atom_;
@@ -55,12 +119,72 @@ const CompMap& Composition::mass() {
     CompMap::iterator it;
     for (it = atom_.begin(); it != atom_.end(); ++it) {
       Nuc nuc = it->first;
-      mass_[nuc] = it->second * pyne::atomic_mass(nuc);
+      mass_[nuc] = it->second * NucData::atomic_mass(nuc);
     }
   }
   return mass_;
 }
 
+const CompVec& Composition::mass_vec() {
+  if (mass_vec_.empty()) {
+    mass_vec_ = CompVec(mass());
+  }
+  return mass_vec_;
+}
+
+double Composition::max_decay_const() {
+  if (max_decay_const_ < 0) {
+    max_decay_const_ = 0;
+    const CompMap& atoms = atom();
+    CompMap::const_iterator it;
+    for (it = atoms.begin(); it != atoms.end(); ++it) {
+      max_decay_const_ =
+          std::max(max_decay_const_, NucData::decay_const(it->first));
+    }
+  }
+  return max_decay_const_;
+}
+
+double Composition::uranium_assay_atom() {
+  ComputeUranium();
+  return u_assay_atom_;
+}
+
+double Composition::uranium_assay_mass() {
+  ComputeUranium();
+  return u_assay_mass_;
+}
+
+double Composition::uranium_mass_frac() {
+  ComputeUranium();
+  return u_mass_frac_;
+}
+
+void Composition::ComputeUranium() {
+  if (u_assay_atom_ >= 0) {
+    return;
+  }
+
+  const CompVec& m = mass_vec();
+  double u235 = m.Get(922350000);
+  double u238 = m.Get(922380000);
+  double tot = 0;
+  const std::vector<double>& vals = m.vals();
+  for (int i = 0; i < vals.size(); ++i) {
+    tot += vals[i];
+  }
+
+  u_assay_mass_ = u235 + u238 > 0 ? u235 / (u235 + u238) : 0;
+  u_mass_frac_ = tot > 0 ? (u235 + u238) / tot : 0;
+
+  const CompMap& atoms = atom();
+  CompMap::const_iterator a235 = atoms.find(922350000);
+  CompMap::const_iterator a238 = atoms.find(922380000);
+  u235 = a235 == atoms.end() ? 0 : a235->second;
+  u238 = a238 == atoms.end() ? 0 : a238->second;
+  u_assay_atom_ = u235 + u238 > 0 ? u235 / (u235 + u238) : 0;
+}
+
 Composition::Ptr Composition::Decay(int delta, uint64_t secs_per_timestep) {
   int tot_decay = prev_decay_ + delta;
   if (decay_line_->count(tot_decay) == 1) {
@@ -82,10 +206,12 @@ Composition::Ptr Composition::Decay(int delta) {
 }
 
 void Composition::Record(Context* ctx) {
-  if (recorded_) {
+  boost::uuids::uuid sim = ctx->sim_id();
+  if (recorded_ && (recorded_sim_.is_nil() || recorded_sim_ == sim)) {
     return;
   }
   recorded_ = true;
+  recorded_sim_ = sim;
 
   CompMap::const_iterator it;
   CompMap cm = mass();  // force lazy evaluation now
@@ -99,18 +225,96 @@ void Composition::Record(Context* ctx) {
   }
 }
 
-Composition::Composition() : prev_decay_(0), recorded_(false) {
-  id_ = next_id_;
-  next_id_++;
+Composition::Composition()
+    : prev_decay_(0),
+      recorded_(false),
+      recorded_sim_(boost::uuids::nil_uuid()),
+      max_decay_const_(-1),
+      u_assay_atom_(-1),
+      u_assay_mass_(0),
+      u_mass_frac_(0),
+      basis_(NOT_INTERNED),
+      hash_(0) {
+  id_ = next_id_.Next();
   decay_line_ = ChainPtr(new Chain());
 }
 
 Composition::Composition(int prev_decay, ChainPtr decay_line)
     : recorded_(false),
+      recorded_sim_(boost::uuids::nil_uuid()),
       prev_decay_(prev_decay),
-      decay_line_(decay_line) {
-  id_ = next_id_;
-  next_id_++;
+      decay_line_(decay_line),
+      max_decay_const_(-1),
+      u_assay_atom_(-1),
+      u_assay_mass_(0),
+      u_mass_frac_(0),
+      basis_(NOT_INTERNED),
+      hash_(0) {
+  id_ = next_id_.Next();
+}
+
+Composition::~Composition() {
+  if (basis_ == NOT_INTERNED) {
+    return;
+  }
+  InternTable& tbl = interned();
+  std::pair<InternTable::iterator, InternTable::iterator> r =
+      tbl.equal_range(hash_);
+  for (InternTable::iterator it = r.first; it != r.second; ++it) {
+    if (it->second == this) {
+      tbl.erase(it);
+      return;
+    }
+  }
+}
+
+Composition::InternTable& Composition::interned() {
+  static InternTable* tbl = new InternTable();
+  return *tbl;
+}
+
+CompVec Composition::Canonical(const CompVec& v) {
+  CompVec canon(v);
+  compmath::Normalize(&canon);
+  std::vector<double>& vals = canon.vals();
+  for (int i = 0; i < vals.size(); ++i) {
+    int exp;
+    double mant = std::frexp(vals[i], &exp);
+    mant = std::floor(std::ldexp(mant, kInternBits) + 0.5);
+    vals[i] = std::ldexp(mant, exp - kInternBits);
+  }
+  return canon;
+}
+
+Composition::Ptr Composition::Lookup(const CompVec& v, Basis basis,
+                                     std::size_t* hash) {
+  CompVec canon = Canonical(v);
+  std::size_t h = boost::hash_range(canon.nucs().begin(), canon.nucs().end());
+  boost::hash_range(h, canon.vals().begin(), canon.vals().end());
+  boost::hash_combine(h, static_cast<int>(basis));
+  *hash = h;
+
+  InternTable& tbl = interned();
+  std::pair<InternTable::iterator, InternTable::iterator> r =
+      tbl.equal_range(h);
+  for (InternTable::iterator it = r.first; it != r.second; ++it) {
+    Composition* other = it->second;
+    if (other->basis_ != basis) {
+      continue;
+    }
+    CompVec otherv =
+        basis == MASS_BASIS ? other->mass_vec() : CompVec(other->atom());
+    if (Canonical(otherv) == canon) {
+      return other->shared_from_this();
+    }
+  }
+  return Ptr();
+}
+
+void Composition::Register(Composition* c, Basis basis, std::size_t hash) {
+  c->basis_ = basis;
+  c->hash_ = hash;
+  interned().insert(std::make_pair(hash, c));
 }
 
 Composition::Ptr Composition::NewDecay(int delta, uint64_t secs_per_timestep) {
@@ -125,7 +329,10 @@ Composition::Ptr Composition::NewDecay(int delta, uint64_t secs_per_timestep) {
   if (atom_.size() == 0)
     return decayed;
 
-  decayed->atom_ = pyne::decayers::decay(atom_, static_cast<double>(secs_per_timestep) * delta);
+  // the operator for this nuclide set and decay time is usually cached from
+  // decays of other compositions or earlier time steps
+  double secs = static_cast<double>(secs_per_timestep) * delta;
+  decayed->atom_ = DecayOp::Get(atom_, secs)->Apply(atom_);
   return decayed;
 }
 
@@ -3,7 +3,13 @@
 
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
+#include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/uuid/uuid.hpp>
+
+#include "id_allocator.h"
 
 class SimInitTest;
 
@@ -16,6 +22,71 @@ typedef int Nuc;
 /// a raw definition of nuclides and corresponding (dimensionless quantities).
 typedef std::map<Nuc, double> CompMap;
 
+/// A contiguous alternative to CompMap holding nuclides and their
+/// (dimensionless) quantities as parallel arrays sorted by nuclide.  Large
+/// compositions (e.g. spent fuel with 1000+ nuclides) are much cheaper to
+/// combine, sum and scale in this form than as a tree of separately
+/// allocated nodes.  CompMap remains the type used at API boundaries;
+/// compmath provides the same operations for both types.
+///
+/// @code
+/// CompVec v(m);  // from a CompMap
+/// compmath::Normalize(&v, 2.0);
+/// CompMap m2 = v.ToMap();
+/// @endcode
+class CompVec {
+ public:
+  CompVec() {}
+
+  /// Creates a vector holding the nuclides and quantities of m.
+  explicit CompVec(const CompMap& m);
+
+  /// Returns the nuclides and quantities as a CompMap.
+  CompMap ToMap() const;
+
+  /// Returns the number of nuclides.
+  int size() const { return nucs_.size(); }
+
+  bool empty() const { return nucs_.empty(); }
+
+  void clear() {
+    nucs_.clear();
+    vals_.clear();
+  }
+
+  void reserve(int n) {
+    nucs_.reserve(n);
+    vals_.reserve(n);
+  }
+
+  /// Appends nuc with quantity val. nuc must be larger than every nuclide
+  /// already in the vector.
+  void Append(Nuc nuc, double val) {
+    nucs_.push_back(nuc);
+    vals_.push_back(val);
+  }
+
+  /// Returns the quantity of nuc or zero if nuc is not present.
+  double Get(Nuc nuc) const;
+
+  /// Returns the sorted nuclides.
+  const std::vector<Nuc>& nucs() const { return nucs_; }
+
+  /// Returns the quantities in the same order as nucs().
+  const std::vector<double>& vals() const { return vals_; }
+
+  /// Returns the quantities for modification in place.
+  std::vector<double>& vals() { return vals_; }
+
+  bool operator==(const CompVec& other) const {
+    return nucs_ == other.nucs_ && vals_ == other.vals_;
+  }
+
+ private:
+  std::vector<Nuc> nucs_;
+  std::vector<double> vals_;
+};
+
 /// An immutable object responsible for holding a nuclide composition. It tracks
 /// decay lineages to prevent duplicate calculations and output recording and is
 /// able to record its composition data to output when told.  Each composition
@@ -35,7 +106,12 @@ typedef std::map<Nuc, double> CompMap;
 /// Composition c = Composition::CreateFromAtom(v);
 /// @endcode
 ///
-class Composition {
+/// Compositions created through the Create functions are interned: creating
+/// a composition whose normalized quantities equal (to about 1e-11 relative)
+/// those of a live composition created on the same basis (mass or atom)
+/// returns the existing object.  Equal compositions therefore share one id,
+/// one decay chain and one set of recorded rows.
+class Composition : public boost::enable_shared_from_this<Composition> {
   friend class SimInit;
   friend class ::SimInitTest;
 
@@ -44,18 +120,24 @@ class Composition {
 
   /// Creates a new composition from v with its components having appropriate
   /// atom-based ratios. v does not need to be normalized to any particular
-  /// value.
+  /// value.  If an equal composition exists it is returned instead, so the
+  /// unnormalized quantities of the result may differ from v by a factor.
   static Ptr CreateFromAtom(CompMap v);
 
   /// Creates a new composition from v with its components having appropriate
   /// mass-based ratios. v does not need to be normalized to any particular
-  /// value.
+  /// value.  If an equal composition exists it is returned instead, so the
+  /// unnormalized quantities of the result may differ from v by a factor.
   static Ptr CreateFromMass(CompMap v);
 
+  /// Creates a new composition from the mass-based quantities in v without
+  /// going through a CompMap first.
+  static Ptr CreateFromMass(const CompVec& v);
+
   /// Returns a unique id associated with this composition.  Note that multiple
-  /// material objects can share the same composition. Also Note that the id is
-  /// not the same for two compositions that were separately created from the
-  /// same CompMap.
+  /// material objects can share the same composition. Also note that
+  /// compositions created from equal CompMaps are the same object and share
+  /// their id.
   int id();
 
   /// Returns the unnormalized atom composition.
@@ -64,6 +146,27 @@ class Composition {
   /// Returns the unnormalized mass composition.
   const CompMap& mass();
 
+  /// Returns the unnormalized mass composition as a CompVec.
+  const CompVec& mass_vec();
+
+  /// Returns the largest decay constant (1/s) of the composition's nuclides.
+  /// It is computed once on first use, so checking whether a decay over some
+  /// time would be significant costs a single exponential.
+  double max_decay_const();
+
+  /// Returns the U-235 atom fraction of the composition's U-235 and U-238,
+  /// or zero if it has neither.  Like the other uranium fractions it is
+  /// computed once on first use, so enrichment code can query it per bid
+  /// without walking the composition.
+  double uranium_assay_atom();
+
+  /// Returns the U-235 mass fraction of the composition's U-235 and U-238,
+  /// or zero if it has neither.
+  double uranium_assay_mass();
+
+  /// Returns the fraction of the composition's mass that is U-235 or U-238.
+  double uranium_mass_frac();
+
   /// Returns a decayed version of this composition (decayed delta timesteps)
   /// assuming a time step is 1/12 of one year in duration. This composition
   /// remains unchanged.
@@ -74,9 +177,11 @@ class Composition {
   Ptr Decay(int delta, uint64_t secs_per_timestep);
 
   /// Records the composition in output database Compositions table (if
-  /// not done previously).
+  /// not done previously for ctx's simulation).
   void Record(Context* ctx);
 
+  ~Composition();
+
  protected:
   /// a chain containing compositions that are a result of decay from a common
   /// ancestor composition. The key is the total amount of time a composition
@@ -97,14 +202,59 @@ class Composition {
   /// Performs a decay calculation and creates a new decayed composition.
   Ptr NewDecay(int delta, uint64_t secs_per_timestep);
 
-  static int next_id_;
+  /// Computes the uranium fractions if they haven't been yet.
+  void ComputeUranium();
+
+  /// the quantities a composition is interned by.
+  enum Basis {
+    NOT_INTERNED = 0,
+    MASS_BASIS,
+    ATOM_BASIS,
+  };
+
+  typedef std::unordered_multimap<std::size_t, Composition*> InternTable;
+
+  /// Returns the live composition with quantities v on the given basis, or
+  /// NULL if there is none.  hash is set to the hash v is interned by.
+  static Ptr Lookup(const CompVec& v, Basis basis, std::size_t* hash);
+
+  /// Registers c as the composition with the given basis and hash.
+  static void Register(Composition* c, Basis basis, std::size_t hash);
+
+  /// Returns the normalized, rounded quantities of v compositions are
+  /// interned by.
+  static CompVec Canonical(const CompVec& v);
+
+  /// Returns the table of interned compositions.  It is never destroyed so
+  /// that compositions outliving static destruction can still unregister.
+  static InternTable& interned();
+
+  static IdAllocator next_id_;
   int id_;
   bool recorded_;
+
+  /// the simulation the composition was recorded in.  Interned compositions
+  /// can outlive a simulation and be reused by the next one in the same
+  /// process.  Nil if recorded_ was set when loading from a database.
+  boost::uuids::uuid recorded_sim_;
   CompMap atom_;
   CompMap mass_;
+  CompVec mass_vec_;
+
+  /// negative until computed by max_decay_const().
+  double max_decay_const_;
+
+  /// u_assay_atom_ is negative until the fractions are computed by
+  /// ComputeUranium().
+  double u_assay_atom_;
+  double u_assay_mass_;
+  double u_mass_frac_;
 
   /// the total time delta this composition has been decayed from its root ancestor.
   int prev_decay_;
+
+  Basis basis_;
+  std::size_t hash_;
 };
 
 }  // namespace cyclus
@@ -1,5 +1,6 @@
 #include "context.h"
 
+#include <algorithm>
 #include <vector>
 #include <boost/uuid/uuid_generators.hpp>
 
@@ -22,6 +23,7 @@ SimInfo::SimInfo()
       m0(0),
       dt(kDefaultTimeStepDur),
       decay("manual"),
+      provenance("full"),
       branch_time(-1),
       explicit_inventory(false),
       explicit_inventory_compact(false),
@@ -34,6 +36,7 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle)
       m0(m0),
       dt(kDefaultTimeStepDur),
       decay("manual"),
+      provenance("full"),
       branch_time(-1),
       handle(handle),
       explicit_inventory(false),
@@ -47,6 +50,7 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle, std::string d)
       m0(m0),
       dt(kDefaultTimeStepDur),
       decay(d),
+      provenance("full"),
       branch_time(-1),
       handle(handle),
       explicit_inventory(false),
@@ -62,6 +66,7 @@ SimInfo::SimInfo(int dur, boost::uuids::uuid parent_sim,
       m0(-1),
       dt(kDefaultTimeStepDur),
       decay("manual"),
+      provenance("full"),
       parent_sim(parent_sim),
       parent_type(parent_type),
       branch_time(branch_time),
@@ -74,7 +79,8 @@ Context::Context(Timer* ti, Recorder* rec)
       rec_(rec),
       solver_(NULL),
       trans_id_(0),
-      si_(0) {}
+      si_(0),
+      prov_(FULL_PROVENANCE) {}
 
 Context::~Context() {
   if (solver_ != NULL) {
@@ -178,7 +184,44 @@ Composition::Ptr Context::GetRecipe(std::string name) {
   return recipes_[name];
 }
 
+void Context::RegisterOutputBuffer(OutputBuffer* b) {
+  if (std::find(out_bufs_.begin(), out_bufs_.end(), b) == out_bufs_.end()) {
+    out_bufs_.push_back(b);
+  }
+}
+
+void Context::UnregisterOutputBuffer(OutputBuffer* b) {
+  std::vector<OutputBuffer*>::iterator it =
+      std::find(out_bufs_.begin(), out_bufs_.end(), b);
+  if (it != out_bufs_.end()) {
+    out_bufs_.erase(it);
+  }
+}
+
+void Context::FlushOutputBuffers() {
+  for (int i = 0; i < out_bufs_.size(); ++i) {
+    out_bufs_[i]->Flush();
+  }
+}
+
+/// Returns the provenance level named p; empty means full.
+static Provenance ParseProvenance(const std::string& p) {
+  if (p == "full" || p.empty()) {
+    return FULL_PROVENANCE;
+  } else if (p == "compact") {
+    return COMPACT_PROVENANCE;
+  } else if (p == "trades") {
+    return TRADE_PROVENANCE;
+  } else if (p == "off") {
+    return NO_PROVENANCE;
+  }
+  throw ValueError("unknown provenance level '" + p + "', expected one of "
+                   "full, compact, trades or off");
+}
+
 void Context::InitSim(SimInfo si) {
+  Provenance prov = ParseProvenance(si.provenance);
+
   NewDatum("Info")
       ->AddVal("Handle", si.handle)
       ->AddVal("InitialYear", si.y0)
@@ -200,6 +243,10 @@ void Context::InitSim(SimInfo si) {
       ->AddVal("Decay", si.decay)
       ->Record();
 
+  NewDatum("ProvenanceMode")
+      ->AddVal("Provenance", si.provenance)
+      ->Record();
+
   NewDatum("InfoExplicitInv")
       ->AddVal("RecordInventory", si.explicit_inventory)
       ->AddVal("RecordInventoryCompact", si.explicit_inventory_compact)
@@ -221,6 +268,7 @@ void Context::InitSim(SimInfo si) {
       ->Record();
 
   si_ = si;
+  prov_ = prov;
   ti_->Initialize(this, si);
 }
 
@@ -236,6 +284,23 @@ void Context::UnregisterTimeListener(TimeListener* tl) {
   ti_->UnregisterTimeListener(tl);
 }
 
+int Context::ResourceTypeId(const ResourceType& type,
+                            const std::string& units) {
+  std::map<std::string, int>::iterator it = res_type_ids_.find(type);
+  if (it != res_type_ids_.end()) {
+    return it->second;
+  }
+
+  int id = res_type_ids_.size() + 1;
+  res_type_ids_[type] = id;
+  NewDatum("ResourceTypes")
+      ->AddVal("TypeId", id)
+      ->AddVal("Type", type)
+      ->AddVal("Units", units)
+      ->Record();
+  return id;
+}
+
 Datum* Context::NewDatum(std::string title) {
   return rec_->NewDatum(title);
 }
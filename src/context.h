@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #ifndef CYCPP
@@ -16,6 +17,7 @@
 #include "composition.h"
 #include "agent.h"
 #include "greedy_solver.h"
+#include "id_allocator.h"
 #include "pyhooks.h"
 #include "recorder.h"
 
@@ -33,6 +35,14 @@ class Timer;
 class TimeListener;
 class SimInit;
 
+/// Resource provenance levels, see SimInfo::provenance.
+enum Provenance {
+  FULL_PROVENANCE,
+  COMPACT_PROVENANCE,
+  TRADE_PROVENANCE,
+  NO_PROVENANCE,
+};
+
 /// Container for a static simulation-global parameters that both describe
 /// the simulation and affect its behavior.
 class SimInfo {
@@ -77,6 +87,20 @@ class SimInfo {
   /// "manual" if use of the decay function is allowed, "never" otherwise
   std::string decay;
 
+  /// How much resource provenance is recorded in the Resources table:
+  ///
+  /// * "full": a row for every create/extract/absorb/modify (default).
+  /// * "compact": the same rows with integer columns only; resource types and
+  ///   units are recorded once in the ResourceTypes table.
+  /// * "trades": rows only for resource states that are traded, with their
+  ///   parent set to the previously traded state of their lineage.
+  /// * "off": no Resources rows.
+  ///
+  /// Resource ids are assigned the same way in every mode so other tables
+  /// (e.g. Transactions, MaterialInfo) still join on ResourceId.  Restarting
+  /// requires "full" or "compact".
+  std::string provenance;
+
   /// length of the simulation in timesteps (months)
   int duration;
 
@@ -115,6 +139,18 @@ class SimInfo {
   bool explicit_inventory_compact;
 };
 
+/// An object that buffers output (e.g. toolkit::TimeSeriesAccumulator) and
+/// must record it before simulation state is snapshotted.  Registered buffers
+/// are flushed at the start of every snapshot, including the one taken at
+/// the end of every simulation, so nothing buffered is lost on a restart.
+class OutputBuffer {
+ public:
+  virtual ~OutputBuffer() {}
+
+  /// Records everything buffered so far.
+  virtual void Flush() = 0;
+};
+
 /// A simulation context provides access to necessary simulation-global
 /// functions and state. All code that writes to the output database, needs to
 /// know simulation time, creates/builds facilities, and/or uses loaded
@@ -226,8 +262,17 @@ class Context {
   /// Agents should unregister from their Decommission method.
   void UnregisterTimeListener(TimeListener* tl);
 
+  /// Registers an output buffer to be flushed before every snapshot.  The
+  /// buffer must be unregistered before it is destroyed.
+  void RegisterOutputBuffer(OutputBuffer* b);
+
+  /// Stops flushing an output buffer.
+  void UnregisterOutputBuffer(OutputBuffer* b);
+
   /// Initializes the simulation time parameters. Should only be called once -
   /// NOT idempotent.
+  ///
+  /// @throws ValueError if si.provenance is not a known provenance level
   void InitSim(SimInfo si);
 
   /// Returns the current simulation timestep.
@@ -237,10 +282,15 @@ class Context {
   inline uint64_t dt() {return si_.dt;};
 
   /// Return static simulation info.
-  inline SimInfo sim_info() const {
+  inline const SimInfo& sim_info() const {
     return si_;
   }
 
+  /// Returns the provenance level parsed from SimInfo::provenance.
+  inline Provenance provenance() const {
+    return prov_;
+  }
+
   /// See Recorder::NewDatum documentation.
   Datum* NewDatum(std::string title);
 
@@ -253,9 +303,13 @@ class Context {
 
   /// @return the next transaction id
   inline int NextTransactionID() {
-    return trans_id_++;
+    return trans_id_.Next();
   }
 
+  /// Returns the id of the resource type in the ResourceTypes table used by
+  /// "compact" provenance, recording the type the first time it is seen.
+  int ResourceTypeId(const ResourceType& type, const std::string& units);
+
   /// Returns the exchange solver associated with this context
   ExchangeSolver* solver() {
     if (solver_ == NULL) {
@@ -295,6 +349,9 @@ class Context {
     n_specs_[a->spec()]--;
   }
 
+  /// Flushes every registered output buffer.
+  void FlushOutputBuffers();
+
   /// contains archetype specs of all agents for which version have already
   /// been recorded in the db
   std::set<std::string> rec_ver_;
@@ -303,14 +360,22 @@ class Context {
   std::map<std::string, Composition::Ptr> recipes_;
   std::set<Agent*> agent_list_;
   std::set<Trader*> traders_;
+
+  /// output buffers in registration order, so rows are recorded in the same
+  /// order on every run
+  std::vector<OutputBuffer*> out_bufs_;
   std::map<std::string, int> n_prototypes_;
   std::map<std::string, int> n_specs_;
 
   SimInfo si_;
+  Provenance prov_;
   Timer* ti_;
   ExchangeSolver* solver_;
   Recorder* rec_;
-  int trans_id_;
+  IdAllocator trans_id_;
+
+  /// ids of the resource types recorded in the ResourceTypes table
+  std::map<std::string, int> res_type_ids_;
 };
 
 }  // namespace cyclus
@@ -6,11 +6,46 @@
 #define CYCLUS_SRC_CYC_ARITHMETIC_H_
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <map>
 #include <vector>
 
 namespace cyclus {
+
+/// A running sum with Neumaier's improved Kahan compensation.  The rounding
+/// error of every addition is carried in a separate term, so long sequences
+/// of additions and subtractions (e.g. an inventory total updated on every
+/// push and pop) don't drift away from the true sum.
+class CompensatedSum {
+ public:
+  explicit CompensatedSum(double v = 0) : sum_(v), comp_(0) {}
+
+  /// Adds x to the sum.
+  inline void Add(double x) {
+    double t = sum_ + x;
+    if (std::abs(sum_) >= std::abs(x)) {
+      comp_ += (sum_ - t) + x;
+    } else {
+      comp_ += (x - t) + sum_;
+    }
+    sum_ = t;
+  }
+
+  /// Resets the sum to v.
+  inline void Reset(double v = 0) {
+    sum_ = v;
+    comp_ = 0;
+  }
+
+  /// Returns the compensated sum.
+  inline double value() const { return sum_ + comp_; }
+
+ private:
+  double sum_;
+  double comp_;
+};
+
 /// @brief CycArithmetic is a toolkit for arithmetic
 class CycArithmetic {
  public:
@@ -23,6 +23,7 @@
 #include "logger.h"
 #include "material.h"
 #include "mock_sim.h"
+#include "nuc_data.h"
 #include "agent.h"
 #include "pyhooks.h"
 #include "pyne.h"
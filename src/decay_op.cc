@@ -0,0 +1,160 @@
+#include "decay_op.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+
+#include "error.h"
+#include "pyne_decay.h"
+
+namespace cyclus {
+
+/// Maximum number of cached decay operators.  The cache is cleared when it
+/// is full so simulations producing many distinct nuclide sets don't grow it
+/// without bound.
+static const int kMaxDecayOps = 4096;
+
+typedef std::pair<double, std::vector<Nuc> > OpKey;
+
+struct OpKeyHash {
+  std::size_t operator()(const OpKey& k) const {
+    std::size_t h = boost::hash_range(k.second.begin(), k.second.end());
+    boost::hash_combine(h, k.first);
+    return h;
+  }
+};
+
+typedef std::unordered_map<OpKey, DecayOp::Ptr, OpKeyHash> OpCache;
+
+static OpCache& cache() {
+  static OpCache c;
+  return c;
+}
+
+DecayOp::DecayOp(const std::vector<Nuc>& parents, double secs)
+    : secs_(secs),
+      parents_(parents) {
+  std::vector<CompMap> cols(parents_.size());
+  for (int j = 0; j < parents_.size(); ++j) {
+    // pyne copies nuclides it has no decay data for to its output unchanged,
+    // whatever their quantity, while it drops non-positive daughters of the
+    // nuclides it does decay; a negative probe tells the two apart
+    CompMap probe;
+    probe[parents_[j]] = -1;
+    probe = pyne::decayers::decay(probe, secs_);
+    if (probe.size() == 1 && probe.begin()->first == parents_[j] &&
+        probe.begin()->second == -1) {
+      passthrough_.push_back(j);
+      continue;
+    }
+
+    CompMap unit;
+    unit[parents_[j]] = 1;
+    cols[j] = pyne::decayers::decay(unit, secs_);
+    for (CompMap::iterator it = cols[j].begin(); it != cols[j].end(); ++it) {
+      daughters_.push_back(it->first);
+    }
+  }
+  std::sort(daughters_.begin(), daughters_.end());
+  daughters_.erase(std::unique(daughters_.begin(), daughters_.end()),
+                   daughters_.end());
+
+  col_start_.reserve(parents_.size() + 1);
+  col_start_.push_back(0);
+  for (int j = 0; j < cols.size(); ++j) {
+    std::vector<Nuc>::iterator row = daughters_.begin();
+    for (CompMap::iterator it = cols[j].begin(); it != cols[j].end(); ++it) {
+      // columns are sorted, so the search can resume from the last row
+      row = std::lower_bound(row, daughters_.end(), it->first);
+      rows_.push_back(row - daughters_.begin());
+      vals_.push_back(it->second);
+    }
+    col_start_.push_back(rows_.size());
+  }
+}
+
+DecayOp::Ptr DecayOp::Get(const CompMap& comp, double secs) {
+  OpKey key(secs, std::vector<Nuc>());
+  key.second.reserve(comp.size());
+  for (CompMap::const_iterator it = comp.begin(); it != comp.end(); ++it) {
+    key.second.push_back(it->first);
+  }
+
+  OpCache& c = cache();
+  OpCache::iterator it = c.find(key);
+  if (it != c.end()) {
+    return it->second;
+  }
+
+  if (c.size() >= kMaxDecayOps) {
+    c.clear();
+  }
+  Ptr op(new DecayOp(key.second, secs));
+  c[key] = op;
+  return op;
+}
+
+void DecayOp::ClearCache() {
+  cache().clear();
+}
+
+int DecayOp::cache_size() {
+  return cache().size();
+}
+
+CompMap DecayOp::Apply(const CompMap& comp) const {
+  if (comp.size() != parents_.size()) {
+    throw ValueError("composition does not match decay operator nuclides");
+  }
+
+  // parents and comp are both sorted, so they are walked in lockstep; this
+  // also sums each daughter in the same order pyne does.
+  std::vector<double> out(daughters_.size(), 0);
+  std::vector<double> kept(passthrough_.size());
+  CompMap::const_iterator it = comp.begin();
+  int q = 0;
+  for (int j = 0; j < parents_.size(); ++j, ++it) {
+    if (it->first != parents_[j]) {
+      throw ValueError("composition does not match decay operator nuclides");
+    }
+    double qty = it->second;
+    if (q < passthrough_.size() && passthrough_[q] == j) {
+      kept[q++] = qty;
+    }
+    for (int k = col_start_[j]; k < col_start_[j + 1]; ++k) {
+      out[rows_[k]] += qty * vals_[k];
+    }
+  }
+
+  // like pyne, pass-through nuclides are kept whatever their quantity, and
+  // positive daughters are merged in, replacing a pass-through entry for the
+  // same nuclide
+  CompMap decayed;
+  int p = 0;
+  for (int i = 0; i < daughters_.size(); ++i) {
+    for (; p < passthrough_.size() &&
+           parents_[passthrough_[p]] < daughters_[i]; ++p) {
+      decayed.insert(decayed.end(),
+                     std::make_pair(parents_[passthrough_[p]], kept[p]));
+    }
+    bool tie = p < passthrough_.size() &&
+               parents_[passthrough_[p]] == daughters_[i];
+    if (out[i] > 0) {
+      decayed.insert(decayed.end(), std::make_pair(daughters_[i], out[i]));
+    } else if (tie) {
+      decayed.insert(decayed.end(), std::make_pair(daughters_[i], kept[p]));
+    }
+    if (tie) {
+      ++p;
+    }
+  }
+  for (; p < passthrough_.size(); ++p) {
+    decayed.insert(decayed.end(),
+                   std::make_pair(parents_[passthrough_[p]], kept[p]));
+  }
+  return decayed;
+}
+
+}  // namespace cyclus
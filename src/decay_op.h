@@ -0,0 +1,79 @@
+#ifndef CYCLUS_SRC_DECAY_OP_H_
+#define CYCLUS_SRC_DECAY_OP_H_
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "composition.h"
+
+namespace cyclus {
+
+/// A decay operator is a sparse transfer matrix that decays atom quantities
+/// of a fixed set of parent nuclides over a fixed time.  Column j holds the
+/// atoms of each daughter produced by one atom of the j-th parent, computed
+/// once from the pyne Bateman kernels.  Because decay is linear, applying the
+/// operator gives the same result as calling pyne::decayers::decay directly,
+/// but only costs a sparse matrix-vector product.
+///
+/// Operators are cached per (nuclide set, decay time) and shared:
+///
+/// @code
+/// DecayOp::Ptr op = DecayOp::Get(comp->atom(), secs);
+/// CompMap decayed = op->Apply(comp->atom());
+/// @endcode
+class DecayOp {
+ public:
+  typedef boost::shared_ptr<const DecayOp> Ptr;
+
+  /// Builds the operator decaying the nuclides in parents (sorted, unique)
+  /// over secs seconds.
+  DecayOp(const std::vector<Nuc>& parents, double secs);
+
+  /// Returns the cached operator for the nuclides in comp and secs seconds,
+  /// building it if necessary.
+  static Ptr Get(const CompMap& comp, double secs);
+
+  /// Clears the operator cache.
+  static void ClearCache();
+
+  /// Returns the number of cached operators.
+  static int cache_size();
+
+  /// Returns comp decayed by this operator.  The nuclides of comp must be
+  /// exactly this operator's parents.  As in pyne, daughters with
+  /// non-positive quantities are dropped, while parents without decay data
+  /// are copied unchanged whatever their quantity.
+  CompMap Apply(const CompMap& comp) const;
+
+  /// the nuclides this operator decays.
+  const std::vector<Nuc>& parents() const { return parents_; }
+
+  /// the nuclides this operator can produce by decay; parents without decay
+  /// data are not included.
+  const std::vector<Nuc>& daughters() const { return daughters_; }
+
+  /// the decay time in seconds.
+  double secs() const { return secs_; }
+
+ private:
+  double secs_;
+  std::vector<Nuc> parents_;
+  std::vector<Nuc> daughters_;
+
+  /// compressed sparse columns: entries col_start_[j] through
+  /// col_start_[j + 1] - 1 of rows_ and vals_ belong to parent j.
+  std::vector<int> col_start_;
+
+  /// the index into daughters_ of each entry.
+  std::vector<int> rows_;
+  std::vector<double> vals_;
+
+  /// the indices into parents_ of nuclides pyne has no decay data for, which
+  /// have empty columns and are copied to the output as is.
+  std::vector<int> passthrough_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_DECAY_OP_H_
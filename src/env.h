@@ -70,6 +70,11 @@ class Env {
   /// CYCLUS_NUC_DATA
   static const std::string nuc_data();
 
+  /// @return the path of the precompiled nuclear data snapshot, which is the
+  /// value of CYCLUS_NUC_DATA_SNAPSHOT if set or else the nuc_data() path
+  /// with a ".snap" suffix.  The file need not exist.
+  static const std::string nuc_data_snapshot();
+
   /// Returns the current rng schema.  Uses CYCLUS_RNG_SCHEMA env var if
   /// set; otherwise uses the default install location. If using the default
   /// location, set flat=true for the default flat schema.
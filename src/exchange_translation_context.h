@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_EXCHANGE_TRANSLATION_CONTEXT_H_
 
 #include <map>
+#include <vector>
 
 #include "bid.h"
 #include "exchange_graph.h"
@@ -21,6 +22,9 @@ struct ExchangeTranslationContext {
   std::map<ExchangeNode::Ptr, Request<T>*> node_to_request;
   std::map<Bid<T>*, ExchangeNode::Ptr> bid_to_node;
   std::map<ExchangeNode::Ptr, Bid<T>*> node_to_bid;
+  /// all nodes of bids standing for several identical bids (see
+  /// BidPortfolio::AddBids); bid_to_node holds the first of them
+  std::map<Bid<T>*, std::vector<ExchangeNode::Ptr> > bid_copy_nodes;
 };
 
 }  // namespace cyclus
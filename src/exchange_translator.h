@@ -93,17 +93,17 @@ class ExchangeTranslator {
          << "This message will go away in before the next release (1.5).";
       throw ValueError(ss.str());
     }
-    // get translated arc
-    Arc a = TranslateArc(xlation_ctx_, bid, pref);
-    a.unode()->prefs[a] = pref;  // request node is a.unode()
-    int n_prefs = a.unode()->prefs.size();
-    
-    CLOG(LEV_DEBUG5) << "Updating preference for one of "
-                     << req->requester()->manager()->prototype()
-                     << "'s trade nodes:";
-    CLOG(LEV_DEBUG5) << "   preference: " << a.unode()->prefs[a];
-    
-    graph->AddArc(a);
+    // get translated arc(s), one per copy of compact bids
+    typename std::map<Bid<T>*, std::vector<ExchangeNode::Ptr> >::iterator it =
+        xlation_ctx_.bid_copy_nodes.find(bid);
+    if (it == xlation_ctx_.bid_copy_nodes.end()) {
+      AddArc(TranslateArc(xlation_ctx_, bid, pref), req, pref, graph);
+      return;
+    }
+    for (int i = 0; i < it->second.size(); ++i) {
+      AddArc(TranslateArc(xlation_ctx_, bid, it->second[i], pref), req, pref,
+             graph);
+    }
   }
   
   /// @brief Provide a vector of Trades given a vector of Matches
@@ -124,6 +124,17 @@ class ExchangeTranslator {
   ExchangeTranslationContext<T>& translation_ctx() { return xlation_ctx_; }
 
  private:
+  void AddArc(Arc a, Request<T>* req, double pref, ExchangeGraph::Ptr graph) {
+    a.unode()->prefs[a] = pref;  // request node is a.unode()
+
+    CLOG(LEV_DEBUG5) << "Updating preference for one of "
+                     << req->requester()->manager()->prototype()
+                     << "'s trade nodes:";
+    CLOG(LEV_DEBUG5) << "   preference: " << a.unode()->prefs[a];
+
+    graph->AddArc(a);
+  }
+
   ExchangeContext<T>* ex_ctx_;
   ExchangeTranslationContext<T> xlation_ctx_;
 };
@@ -196,15 +207,32 @@ ExchangeNodeGroup::Ptr TranslateBidPortfolio(
        b_it != bp->bids().end();
        ++b_it) {
     Bid<T>* b = *b_it;
-    ExchangeNode::Ptr n(
-        new ExchangeNode(b->offer()->quantity(),
-                         b->exclusive(),
-                         b->request()->commodity(),
-                         b->bidder()->manager()->id()));
-    bs->AddExchangeNode(n);
-    AddBid(translation_ctx, *b_it, n);
-    if (b->exclusive()) {
-      excl_bid_grps[b->offer()].push_back(n);
+    int ncopies = bp->copies(b);
+    for (int i = 0; i < ncopies; ++i) {
+      ExchangeNode::Ptr n(
+          new ExchangeNode(b->offer()->quantity(),
+                           b->exclusive(),
+                           b->request()->commodity(),
+                           b->bidder()->manager()->id()));
+      bs->AddExchangeNode(n);
+      if (ncopies == 1) {
+        AddBid(translation_ctx, b, n);
+        if (b->exclusive()) {
+          excl_bid_grps[b->offer()].push_back(n);
+        }
+        continue;
+      }
+
+      // copies of a compact bid share an offer but are independent, so each
+      // is an exclusive group of its own
+      if (i == 0) {
+        AddBid(translation_ctx, b, n);
+      } else {
+        translation_ctx.node_to_bid[n] = b;
+      }
+      translation_ctx.bid_copy_nodes[b].push_back(n);
+      std::vector<ExchangeNode::Ptr> grp(1, n);
+      bs->AddExclGroup(grp);
     }
   }
 
@@ -240,9 +268,17 @@ Arc TranslateArc(const ExchangeTranslationContext<T>& translation_ctx,
 template <class T>
 Arc TranslateArc(const ExchangeTranslationContext<T>& translation_ctx,
                  Bid<T>* bid, double pref) {
+  return TranslateArc<T>(translation_ctx, bid,
+                         translation_ctx.bid_to_node.at(bid), pref);
+}
+
+/// @brief translates an arc from the bid node vnode, which is one of the
+/// nodes of bid (see BidPortfolio::AddBids)
+template <class T>
+Arc TranslateArc(const ExchangeTranslationContext<T>& translation_ctx,
+                 Bid<T>* bid, ExchangeNode::Ptr vnode, double pref) {
   Request<T>* req = bid->request();
   ExchangeNode::Ptr unode = translation_ctx.request_to_node.at(req);
-  ExchangeNode::Ptr vnode = translation_ctx.bid_to_node.at(bid);
   Arc arc(unode, vnode);
   arc.pref(pref); 
   
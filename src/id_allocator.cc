@@ -0,0 +1,125 @@
+#include "id_allocator.h"
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+
+#include "error.h"
+
+namespace cyclus {
+
+/// All live allocators, so a region can capture their bases when it starts.
+/// Allocators are created rarely (mostly as statics and one per Context), so
+/// a lock is fine here; it is never taken when allocating ids.
+struct AllocatorRegistry {
+  std::mutex mu;
+  std::set<IdAllocator*> all;
+};
+
+static AllocatorRegistry& registry() {
+  static AllocatorRegistry* r = new AllocatorRegistry();
+  return *r;
+}
+
+/// The active region, if any.
+static std::atomic<IdBlocks*> active_blocks(NULL);
+
+thread_local IdBlocks::LaneState* IdBlocks::current_ = NULL;
+
+IdAllocator::IdAllocator(int first) : next_(first), base_(first) {
+  AllocatorRegistry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mu);
+  r.all.insert(this);
+}
+
+IdAllocator::~IdAllocator() {
+  AllocatorRegistry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mu);
+  r.all.erase(this);
+}
+
+int IdAllocator::Next() {
+  IdBlocks::LaneState* l = IdBlocks::current_;
+  if (l != NULL) {
+    return l->blocks->Next(l, this);
+  } else if (active_blocks.load(std::memory_order_relaxed) != NULL) {
+    throw StateError("ids allocated outside of an IdBlocks lane while "
+                     "lanes are active");
+  }
+  return next_.fetch_add(1);
+}
+
+IdBlocks::IdBlocks(int nlanes, int block_size) : block_size_(block_size) {
+  if (nlanes < 1 || block_size < 1) {
+    throw ValueError("IdBlocks needs a positive number of lanes and "
+                     "block size");
+  }
+  IdBlocks* none = NULL;
+  if (!active_blocks.compare_exchange_strong(none, this)) {
+    throw StateError("only one IdBlocks region may be active at a time");
+  }
+
+  lanes_.resize(nlanes);
+  for (int i = 0; i < nlanes; ++i) {
+    lanes_[i].blocks = this;
+    lanes_[i].index = i;
+  }
+
+  AllocatorRegistry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mu);
+  std::set<IdAllocator*>::iterator it;
+  for (it = r.all.begin(); it != r.all.end(); ++it) {
+    (*it)->base_ = (*it)->next_.load();
+  }
+}
+
+IdBlocks::~IdBlocks() {
+  // every allocator resumes after the last round of blocks handed out; this
+  // only depends on how many blocks each lane used
+  std::map<IdAllocator*, int> rounds;
+  for (int i = 0; i < lanes_.size(); ++i) {
+    std::map<IdAllocator*, Stripe>::iterator it;
+    for (it = lanes_[i].stripes.begin(); it != lanes_[i].stripes.end();
+         ++it) {
+      int& n = rounds[it->first];
+      n = std::max(n, it->second.nblocks);
+    }
+  }
+
+  {
+    AllocatorRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mu);
+    std::map<IdAllocator*, int>::iterator it;
+    for (it = rounds.begin(); it != rounds.end(); ++it) {
+      if (r.all.count(it->first) != 0) {
+        it->first->next_.store(it->first->base_ +
+                               it->second * nlanes() * block_size_);
+      }
+    }
+  }
+  active_blocks.store(NULL);
+}
+
+int IdBlocks::Next(LaneState* l, IdAllocator* a) {
+  Stripe& s = l->stripes[a];
+  if (s.next == s.end) {
+    int block = s.nblocks * nlanes() + l->index;
+    s.next = a->base_ + block * block_size_;
+    s.end = s.next + block_size_;
+    ++s.nblocks;
+  }
+  return s.next++;
+}
+
+IdBlocks::Lane::Lane(IdBlocks* blocks, int i) {
+  if (i < 0 || i >= blocks->nlanes()) {
+    throw ValueError("invalid IdBlocks lane");
+  }
+  current_ = &blocks->lanes_[i];
+}
+
+IdBlocks::Lane::~Lane() {
+  current_ = NULL;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,133 @@
+#ifndef CYCLUS_SRC_ID_ALLOCATOR_H_
+#define CYCLUS_SRC_ID_ALLOCATOR_H_
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+namespace cyclus {
+
+class IdBlocks;
+
+/// Hands out increasing integer ids (e.g. resource state ids, composition
+/// ids, transaction ids).  Next is safe to call from any thread.  Outside of
+/// an IdBlocks region ids are consecutive.  Inside one, each lane draws ids
+/// from its own blocks, so the ids a lane gets only depend on the lane and
+/// the order of its own requests - not on how the lanes' threads interleave.
+class IdAllocator {
+  friend class IdBlocks;
+
+ public:
+  /// @param first the first id handed out
+  explicit IdAllocator(int first = 1);
+
+  ~IdAllocator();
+
+  /// Returns a new unique id.
+  ///
+  /// @throws StateError if called inside an IdBlocks region from a thread
+  /// that has not entered a lane.
+  int Next();
+
+  /// Returns the id the next call to Next will return outside of an IdBlocks
+  /// region.
+  int next() const {
+    return next_.load();
+  }
+
+  /// Sets the next id to hand out, e.g. when restarting a simulation.
+  void next(int id) {
+    next_.store(id);
+  }
+
+ private:
+  // ids are shared across threads, so allocators aren't copyable
+  IdAllocator(const IdAllocator&);
+  IdAllocator& operator=(const IdAllocator&);
+
+  std::atomic<int> next_;
+
+  /// next_ when the current IdBlocks region started
+  int base_;
+};
+
+/// Makes id allocation deterministic while a fixed number of lanes (e.g.
+/// groups of agents ticked in parallel) run concurrently.  While an IdBlocks
+/// object exists, every IdAllocator splits the ids following its current
+/// next id into blocks of block_size ids that are dealt to the lanes in
+/// turn: lane i gets blocks i, i + nlanes, i + 2 * nlanes, ... and takes a
+/// new block without locking or coordinating with other lanes whenever it
+/// exhausts its current one.  When the region ends, each allocator resumes
+/// after the last round of blocks any lane used, so ids stay unique and
+/// reproducible, at the cost of unused ids between regions.
+///
+/// Threads must enter a lane (see Lane) before allocating ids in a region,
+/// and two threads must not use the same lane at the same time.  Only one
+/// region may be active at a time.
+///
+/// @code
+/// IdBlocks blocks(groups.size());
+/// // in the thread running group i:
+/// IdBlocks::Lane lane(&blocks, i);
+/// ... create resources ...
+/// @endcode
+class IdBlocks {
+ public:
+  /// The default number of ids in a block.
+  static const int kDefaultBlockSize = 1024;
+
+  /// Binds the constructing thread to a lane of an IdBlocks region until it
+  /// is destroyed.
+  class Lane {
+   public:
+    /// @throws ValueError if i is not a valid lane of blocks
+    Lane(IdBlocks* blocks, int i);
+    ~Lane();
+  };
+
+  /// @throws ValueError if nlanes or block_size is not positive
+  /// @throws StateError if another region is active
+  IdBlocks(int nlanes, int block_size = kDefaultBlockSize);
+
+  /// Ends the region and advances every allocator past its used blocks.
+  ~IdBlocks();
+
+  /// Returns the number of lanes.
+  int nlanes() const {
+    return lanes_.size();
+  }
+
+ private:
+  IdBlocks(const IdBlocks&);
+  IdBlocks& operator=(const IdBlocks&);
+
+  friend class IdAllocator;
+
+  /// The block a lane is currently using for one allocator.
+  struct Stripe {
+    Stripe() : next(0), end(0), nblocks(0) {}
+    int next;
+    int end;
+    /// number of blocks the lane has taken from the allocator
+    int nblocks;
+  };
+
+  struct LaneState {
+    IdBlocks* blocks;
+    int index;
+    std::map<IdAllocator*, Stripe> stripes;
+  };
+
+  /// Returns the next id of a for lane l.
+  int Next(LaneState* l, IdAllocator* a);
+
+  /// the lane the calling thread has entered, if any
+  static thread_local LaneState* current_;
+
+  int block_size_;
+  std::vector<LaneState> lanes_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_ID_ALLOCATOR_H_
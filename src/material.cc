@@ -2,6 +2,10 @@
 
 #include <math.h>
 
+#include <map>
+#include <set>
+#include <utility>
+
 #include "comp_math.h"
 #include "context.h"
 #include "decayer.h"
@@ -65,6 +69,10 @@ Resource::Ptr Material::ExtractRes(double qty) {
   return boost::static_pointer_cast<Resource>(ExtractQty(qty));
 }
 
+void Material::Traded() {
+  tracker_.Trade();
+}
+
 Material::Ptr Material::ExtractQty(double qty) {
   return ExtractComp(qty, comp_);
 }
@@ -76,12 +84,10 @@ Material::Ptr Material::ExtractComp(double qty, Composition::Ptr c,
   }
 
   // TODO: decide if ExtractComp should force lazy-decay by calling comp()
-  if (comp_ != c) {
-    CompMap v(comp_->mass());
-    compmath::Normalize(&v, qty_);
-    CompMap otherv(c->mass());
-    compmath::Normalize(&otherv, qty);
-    CompMap newv = compmath::Sub(v, otherv);
+  // Extracting nothing or this material's own composition leaves the
+  // remaining composition unchanged.
+  if (comp_ != c && qty != 0) {
+    CompVec newv = compmath::Mix(comp_->mass_vec(), qty_, c->mass_vec(), -qty);
     compmath::ApplyThreshold(&newv, threshold);
     comp_ = Composition::CreateFromMass(newv);
   }
@@ -104,12 +110,14 @@ void Material::Absorb(Material::Ptr mat) {
   Composition::Ptr c0 = comp();
   Composition::Ptr c1 = mat->comp();
 
-  if (c0 != c1) {
-    CompMap v(c0->mass());
-    compmath::Normalize(&v, qty_);
-    CompMap otherv(c1->mass());
-    compmath::Normalize(&otherv, mat->qty_);
-    comp_ = Composition::CreateFromMass(compmath::Add(v, otherv));
+  // Only mix when both materials contribute to the result.  Absorbing into
+  // an empty material adopts the other composition as is, keeping its id and
+  // decay chain.
+  if (c0 != c1 && qty_ == 0) {
+    comp_ = c1;
+  } else if (c0 != c1 && mat->qty_ != 0) {
+    comp_ = Composition::CreateFromMass(
+        compmath::Mix(c0->mass_vec(), qty_, c1->mass_vec(), mat->qty_));
   }
 
   // Set the decay time to the value of the material that had the larger
@@ -125,6 +133,77 @@ void Material::Absorb(Material::Ptr mat) {
   tracker_.Absorb(&mat->tracker_);
 }
 
+void Material::Absorb(const std::vector<Material::Ptr>& mats) {
+  // quantities are zeroed as they're absorbed, so a repeated material would
+  // be counted twice
+  std::set<Material*> seen;
+  for (int i = 0; i < mats.size(); ++i) {
+    if (mats[i].get() == this) {
+      throw ValueError("cannot absorb a material into itself");
+    } else if (!seen.insert(mats[i].get()).second) {
+      throw ValueError("duplicate material absorb attempted");
+    }
+  }
+
+  if (mats.size() < 2) {
+    if (!mats.empty()) {
+      Absorb(mats[0]);
+    }
+    return;
+  }
+
+  // total the quantity contributed by each distinct composition, in order of
+  // first appearance; materials sharing a composition need no mixing
+  std::vector<Composition::Ptr> comps;
+  std::vector<double> qtys;
+  std::map<Composition*, int> index;
+  std::vector<ResTracker*> trackers;
+  trackers.reserve(mats.size());
+  double qty = qty_;
+  for (int i = -1; i < static_cast<int>(mats.size()); ++i) {
+    Material* m = i < 0 ? this : mats[i].get();
+    // this forces lazy evaluation if in lazy decay mode
+    Composition::Ptr c = m->comp();
+    if (i >= 0) {
+      trackers.push_back(&m->tracker_);
+      // same decay time rule as absorbing one at a time
+      if (qty < m->qty_) {
+        prev_decay_time_ = m->prev_decay_time_;
+      }
+      qty += m->qty_;
+    }
+    if (m->qty_ == 0) {
+      continue;
+    }
+    std::map<Composition*, int>::iterator it = index.find(c.get());
+    if (it == index.end()) {
+      index[c.get()] = comps.size();
+      comps.push_back(c);
+      qtys.push_back(m->qty_);
+    } else {
+      qtys[it->second] += m->qty_;
+    }
+  }
+
+  if (comps.size() == 1) {
+    comp_ = comps[0];
+  } else if (comps.size() > 1) {
+    std::vector<const CompVec*> vs(comps.size());
+    for (int i = 0; i < comps.size(); ++i) {
+      vs[i] = &comps[i]->mass_vec();
+    }
+    comp_ = Composition::CreateFromMass(compmath::Mix(vs, qtys));
+  } else if (qty_ == 0) {
+    comp_ = mats.back()->comp();
+  }
+
+  qty_ = qty;
+  for (int i = 0; i < mats.size(); ++i) {
+    mats[i]->qty_ = 0;
+  }
+  tracker_.Absorb(trackers);
+}
+
 void Material::Transmute(Composition::Ptr c) {
   comp_ = c;
   tracker_.Modify();
@@ -142,8 +221,50 @@ void Material::Transmute(Composition::Ptr c) {
 }
 
 void Material::Decay(int curr_time) {
-  if (ctx_ != NULL && ctx_->sim_info().decay == "never") {
+  curr_time = DecayTime(curr_time);
+  int dt = curr_time - prev_decay_time_;
+  if (curr_time < 0 || dt == 0) {
+    return;
+  }
+
+  Composition::Ptr decayed = DecayComp(comp_, dt, SecsPerTimestep());
+  if (decayed == NULL) {
     return;
+  }
+  prev_decay_time_ = curr_time; // this must go before Transmute call
+  Transmute(decayed);
+}
+
+void Material::DecayAll(std::vector<Material::Ptr>& mats, int curr_time) {
+  typedef std::pair<Composition*, std::pair<int, uint64_t> > Key;
+  std::map<Key, Composition::Ptr> decayed;
+
+  for (int i = 0; i < mats.size(); ++i) {
+    Material* m = mats[i].get();
+    int t = m->DecayTime(curr_time);
+    int dt = t - m->prev_decay_time_;
+    if (t < 0 || dt == 0) {
+      continue;
+    }
+
+    uint64_t secs = m->SecsPerTimestep();
+    Key key(m->comp_.get(), std::make_pair(dt, secs));
+    std::map<Key, Composition::Ptr>::iterator it = decayed.find(key);
+    if (it == decayed.end()) {
+      it = decayed.insert(
+          std::make_pair(key, DecayComp(m->comp_, dt, secs))).first;
+    }
+    if (it->second == NULL) {
+      continue;
+    }
+    m->prev_decay_time_ = t; // this must go before Transmute call
+    m->Transmute(it->second);
+  }
+}
+
+int Material::DecayTime(int curr_time) {
+  if (ctx_ != NULL && ctx_->sim_info().decay == "never") {
+    return -1;
   } else if (curr_time < 0 && ctx_ == NULL) {
     throw ValueError("decay cannot use default time with NULL context");
   }
@@ -151,46 +272,36 @@ void Material::Decay(int curr_time) {
   if (curr_time < 0) {
     curr_time = ctx_->time();
   }
+  return curr_time;
+}
 
-  int dt = curr_time - prev_decay_time_;
-  if (dt == 0) {
-    return;
+uint64_t Material::SecsPerTimestep() {
+  if (ctx_ != NULL) {
+    return ctx_->sim_info().dt;
   }
+  return kDefaultTimeStepDur;
+}
 
+Composition::Ptr Material::DecayComp(Composition::Ptr c, int dt,
+                                     uint64_t secs_per_timestep) {
   double eps = 1e-3;
-  const CompMap c = comp_->atom();
 
   // If composition has too many nuclides (i.e. > 100), it is cheaper to
   // just do the decay rather than check all the decay constants.
-  bool decay = c.size() > 100;
-
-  uint64_t secs_per_timestep = kDefaultTimeStepDur;
-  if (ctx_ != NULL) {
-    secs_per_timestep = ctx_->sim_info().dt;
-  }
+  bool decay = c->atom().size() > 100;
 
   if (!decay) {
     // Only do the decay calc if one of the nuclides would change in number
-    // density more than fraction eps.
-    // i.e. decay if   (1 - eps) > exp(-lambda*dt)
-    CompMap::const_reverse_iterator it;
-    for (it = c.rbegin(); it != c.rend(); ++it) {
-      int nuc = it->first;
-      double lambda_timesteps = pyne::decay_const(nuc) * static_cast<double>(secs_per_timestep);
-      double change = 1.0 - std::exp(-lambda_timesteps * static_cast<double>(dt));
-      if (change >= eps) {
-        decay = true;
-        break;
-      }
-    }
-    if (!decay) {
-      return;
+    // density more than fraction eps, i.e. decay if
+    // (1 - eps) > exp(-lambda*dt) for the largest decay constant lambda.
+    double lambda_timesteps = c->max_decay_const() * static_cast<double>(secs_per_timestep);
+    double change = 1.0 - std::exp(-lambda_timesteps * static_cast<double>(dt));
+    if (change < eps) {
+      return Composition::Ptr();
     }
   }
 
-  prev_decay_time_ = curr_time; // this must go before Transmute call
-  Composition::Ptr decayed = comp_->Decay(dt, secs_per_timestep);
-  Transmute(decayed);
+  return c->Decay(dt, secs_per_timestep);
 }
 
 double Material::DecayHeat() {
@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_MATERIAL_H_
 
 #include <list>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #include "composition.h"
@@ -107,6 +108,10 @@ class Material: public Resource {
 
   virtual Resource::Ptr ExtractRes(double qty);
 
+  /// Records this material's state if the provenance setting only tracks
+  /// trades.
+  virtual void Traded();
+
   /// Same as ExtractComp with c = this->comp().
   Ptr ExtractQty(double qty);
 
@@ -123,6 +128,14 @@ class Material: public Resource {
   /// Combines material mat with this one.  mat's quantity becomes zero.
   void Absorb(Ptr mat);
 
+  /// Combines all of mats with this one at once.  The result is the same as
+  /// absorbing each in turn, but the combined composition is computed in a
+  /// single weighted pass and only one new resource state is recorded.  The
+  /// quantities of mats become zero.
+  /// @throws ValueError if mats contains this material or the same material
+  /// more than once
+  void Absorb(const std::vector<Ptr>& mats);
+
   /// Changes the material's composition to c without changing its mass.  Use
   /// this method for things like converting fresh to spent fuel via burning in
   /// a reactor.
@@ -138,6 +151,14 @@ class Material: public Resource {
   /// constants are significant with respect to the time delta.
   void Decay(int curr_time);
 
+  /// Decays every material in mats to curr_time as if Decay(curr_time) were
+  /// called on each of them.  Materials sharing a composition and time delta
+  /// (e.g. thousands of identical assemblies in a repository) are grouped so
+  /// the decay significance check and decay calculation are done once per
+  /// group rather than once per material.  If curr_time is negative, each
+  /// material's context time is used.
+  static void DecayAll(std::vector<Ptr>& mats, int curr_time = -1);
+
   /// Returns the last time step on which a decay calculation was performed
   /// for the material.  This is not necessarily synonymous with the last time
   /// step the material's Decay function was called.
@@ -157,6 +178,18 @@ class Material: public Resource {
   Material(Context* ctx, double quantity, Composition::Ptr c);
 
  private:
+  /// Returns the time decay should advance this material to, or -1 if the
+  /// material's decay mode is "never".
+  int DecayTime(int curr_time);
+
+  /// Returns the seconds per time step used for decay calculations.
+  uint64_t SecsPerTimestep();
+
+  /// Returns the composition c decayed by dt time steps, or NULL if no
+  /// nuclide would change in number density by a significant fraction.
+  static Composition::Ptr DecayComp(Composition::Ptr c, int dt,
+                                    uint64_t secs_per_timestep);
+
   Context* ctx_;
   double qty_;
   Composition::Ptr comp_;
@@ -0,0 +1,314 @@
+#include "mem_back.h"
+
+#include <sstream>
+
+#include "blob.h"
+#include "datum.h"
+#include "error.h"
+#include "recorder.h"
+
+namespace cyclus {
+
+/// names of the key columns that get hash indexes.
+static const char* kIndexFields[] = {"SimId", "ResourceId", "AgentId",
+                                     "QualId", "Time"};
+
+MemBack::MemBack() {}
+
+MemBack::~MemBack() {}
+
+void MemBack::Notify(DatumList data) {
+  for (DatumList::iterator it = data.begin(); it != data.end(); ++it) {
+    std::string tbl = (*it)->title();
+    if (tables_.count(tbl) == 0) {
+      CreateTable(*it);
+    }
+    Append(tables_[tbl], *it);
+  }
+}
+
+std::string MemBack::Name() {
+  return "MemBack";
+}
+
+QueryResult MemBack::Query(std::string table, std::vector<Cond>* conds) {
+  Table& t = GetTable(table);
+  int ncols = t.cols.size();
+
+  QueryResult qr;
+  std::map<std::string, int> idx;
+  for (int j = 0; j < ncols; ++j) {
+    qr.fields.push_back(t.cols[j].name);
+    qr.types.push_back(t.cols[j].type);
+    idx[t.cols[j].name] = j;
+  }
+
+  // the smallest row set from an equality condition on an indexed column is
+  // used as the candidate list, otherwise every row is a candidate.  Every
+  // condition is checked against the schema before any rows are returned.
+  std::vector<std::pair<int, Cond*> > checks;
+  const std::vector<int>* cands = NULL;
+  bool none = false;
+  if (conds != NULL) {
+    for (int i = 0; i < conds->size(); ++i) {
+      Cond* cond = &(*conds)[i];
+      if (idx.count(cond->field) == 0) {
+        throw ValueError("condition on unknown field '" + cond->field +
+                         "' in table '" + table + "'");
+      }
+      int j = idx[cond->field];
+      checks.push_back(std::make_pair(j, cond));
+      if (cond->opcode == EQ && t.cols[j].indexable) {
+        const std::vector<int>* rows = Lookup(t.cols[j], cond);
+        if (rows == NULL) {
+          none = true;
+        } else if (cands == NULL || rows->size() < cands->size()) {
+          cands = rows;
+        }
+      }
+    }
+  }
+  if (none) {
+    return qr;
+  }
+
+  int n = cands == NULL ? t.nrows : cands->size();
+  for (int i = 0; i < n; ++i) {
+    int row = cands == NULL ? i : (*cands)[i];
+    bool match = true;
+    for (int k = 0; k < checks.size() && match; ++k) {
+      match = Match(t.cols[checks[k].first], row, checks[k].second);
+    }
+    if (!match) {
+      continue;
+    }
+
+    QueryRow r(ncols);
+    for (int j = 0; j < ncols; ++j) {
+      r[j] = Value(t.cols[j], row);
+    }
+    qr.rows.push_back(r);
+  }
+  return qr;
+}
+
+std::map<std::string, DbTypes> MemBack::ColumnTypes(std::string table) {
+  Table& t = GetTable(table);
+  std::map<std::string, DbTypes> rtn;
+  for (int i = 0; i < t.cols.size(); ++i) {
+    rtn[t.cols[i].name] = t.cols[i].type;
+  }
+  return rtn;
+}
+
+std::list<ColumnInfo> MemBack::Schema(std::string table) {
+  Table& t = GetTable(table);
+  std::list<ColumnInfo> schema;
+  for (int i = 0; i < t.cols.size(); ++i) {
+    schema.push_back(ColumnInfo(table, t.cols[i].name, i, t.cols[i].type,
+                                std::vector<int>()));
+  }
+  return schema;
+}
+
+std::set<std::string> MemBack::Tables() {
+  std::set<std::string> rtn;
+  std::map<std::string, Table>::iterator it;
+  for (it = tables_.begin(); it != tables_.end(); ++it) {
+    rtn.insert(it->first);
+  }
+  return rtn;
+}
+
+void MemBack::Export(RecBackend* b) {
+  // SimId values are already stored in the tables
+  Recorder rec(false);
+  rec.RegisterBackend(b);
+
+  std::map<std::string, Table>::iterator it;
+  for (it = tables_.begin(); it != tables_.end(); ++it) {
+    Table& t = it->second;
+    for (int i = 0; i < t.nrows; ++i) {
+      Datum* d = rec.NewDatum(it->first);
+      for (int j = 0; j < t.cols.size(); ++j) {
+        d->AddVal(t.cols[j].name.c_str(), Value(t.cols[j], i));
+      }
+      d->Record();
+    }
+  }
+  rec.Close();
+}
+
+void MemBack::CreateTable(Datum* d) {
+  Table& t = tables_[d->title()];
+  const Datum::Vals& vals = d->vals();
+  for (int i = 0; i < vals.size(); ++i) {
+    Column c;
+    c.name = vals[i].first;
+    c.type = DbTypeOf(vals[i].second);
+    if (c.type == INT || c.type == UUID) {
+      int nfields = sizeof(kIndexFields) / sizeof(kIndexFields[0]);
+      for (int k = 0; k < nfields; ++k) {
+        c.indexable = c.indexable || c.name == kIndexFields[k];
+      }
+    }
+    t.cols.push_back(c);
+  }
+}
+
+void MemBack::Append(Table& t, Datum* d) {
+  const Datum::Vals& vals = d->vals();
+  if (vals.size() != t.cols.size()) {
+    std::stringstream ss;
+    ss << "datum for table '" << d->title() << "' has " << vals.size()
+       << " fields, expected " << t.cols.size();
+    throw ValueError(ss.str());
+  }
+
+  int row = t.nrows;
+  for (int i = 0; i < vals.size(); ++i) {
+    Column& c = t.cols[i];
+    const boost::spirit::hold_any& v = vals[i].second;
+    switch (c.type) {
+      case INT: {
+        int x = v.cast<int>();
+        c.ints.push_back(x);
+        if (c.indexed) {
+          c.int_idx[x].push_back(row);
+        }
+        break;
+      }
+      case BOOL: {
+        c.bools.push_back(v.cast<bool>());
+        break;
+      }
+      case FLOAT: {
+        c.floats.push_back(v.cast<float>());
+        break;
+      }
+      case DOUBLE: {
+        c.doubles.push_back(v.cast<double>());
+        break;
+      }
+      case UUID: {
+        boost::uuids::uuid x = v.cast<boost::uuids::uuid>();
+        c.uuids.push_back(x);
+        if (c.indexed) {
+          c.uuid_idx[x].push_back(row);
+        }
+        break;
+      }
+      case STRING: {
+        c.strs.push_back(v.cast<std::string>());
+        break;
+      }
+      default: {
+        c.anys.push_back(v);
+        break;
+      }
+    }
+  }
+  t.nrows++;
+}
+
+void MemBack::BuildIndex(Column& c) {
+  if (c.type == INT) {
+    for (int i = 0; i < c.ints.size(); ++i) {
+      c.int_idx[c.ints[i]].push_back(i);
+    }
+  } else {
+    for (int i = 0; i < c.uuids.size(); ++i) {
+      c.uuid_idx[c.uuids[i]].push_back(i);
+    }
+  }
+  c.indexed = true;
+}
+
+const std::vector<int>* MemBack::Lookup(Column& c, Cond* cond) {
+  if (!c.indexed) {
+    BuildIndex(c);
+  }
+
+  if (c.type == INT) {
+    IntIndex::iterator it = c.int_idx.find(cond->val.cast<int>());
+    return it == c.int_idx.end() ? NULL : &it->second;
+  }
+  UuidIndex::iterator it =
+      c.uuid_idx.find(cond->val.cast<boost::uuids::uuid>());
+  return it == c.uuid_idx.end() ? NULL : &it->second;
+}
+
+bool MemBack::Match(const Column& c, int row, Cond* cond) {
+  switch (c.type) {
+    case INT: {
+      int x = c.ints[row];
+      return CmpCond<int>(&x, cond);
+    }
+    case BOOL: {
+      bool x = c.bools[row];
+      return CmpCond<bool>(&x, cond);
+    }
+    case FLOAT: {
+      float x = c.floats[row];
+      return CmpCond<float>(&x, cond);
+    }
+    case DOUBLE: {
+      double x = c.doubles[row];
+      return CmpCond<double>(&x, cond);
+    }
+    case UUID: {
+      boost::uuids::uuid x = c.uuids[row];
+      return CmpCond<boost::uuids::uuid>(&x, cond);
+    }
+    case STRING: {
+      std::string x = c.strs[row];
+      return CmpCond<std::string>(&x, cond);
+    }
+    case BLOB: {
+      Blob x = c.anys[row].cast<Blob>();
+      return CmpCond<Blob>(&x, cond);
+    }
+    default: {
+      throw ValueError("conditions on column '" + c.name +
+                       "' are not supported");
+    }
+  }
+}
+
+boost::spirit::hold_any MemBack::Value(const Column& c, int row) {
+  boost::spirit::hold_any v;
+  switch (c.type) {
+    case INT:
+      v = c.ints[row];
+      break;
+    case BOOL:
+      v = static_cast<bool>(c.bools[row]);
+      break;
+    case FLOAT:
+      v = c.floats[row];
+      break;
+    case DOUBLE:
+      v = c.doubles[row];
+      break;
+    case UUID:
+      v = c.uuids[row];
+      break;
+    case STRING:
+      v = c.strs[row];
+      break;
+    default:
+      v = c.anys[row];
+      break;
+  }
+  return v;
+}
+
+MemBack::Table& MemBack::GetTable(const std::string& table) {
+  std::map<std::string, Table>::iterator it = tables_.find(table);
+  if (it == tables_.end()) {
+    throw ValueError("Invalid table name " + table);
+  }
+  return it->second;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,133 @@
+#ifndef CYCLUS_SRC_MEM_BACK_H_
+#define CYCLUS_SRC_MEM_BACK_H_
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+#include "query_backend.h"
+
+namespace cyclus {
+
+/// A backend that keeps all recorded data in memory for fast in-process
+/// analysis.  Identically named Datum objects have their data placed as rows
+/// in a single table, with each column stored as a vector of its C++ type.
+/// Integer and uuid columns named SimId, ResourceId, AgentId, QualId or Time
+/// get a hash index the first time they are used in an equality condition,
+/// so point lookups on them (e.g. when restarting a simulation) don't scan
+/// the whole table.  Once indexed, a column's index is kept up to date as new
+/// rows arrive.
+///
+/// Example usage:
+///
+/// @code
+///
+/// MemBack* back = new MemBack();
+/// rec.RegisterBackend(back);
+/// ...
+/// rec.Flush();
+/// QueryResult qr = back->Query("Resources", &conds);
+/// ...
+/// SqliteBack disk("out.sqlite");
+/// back->Export(&disk);
+///
+/// @endcode
+class MemBack: public FullBackend {
+ public:
+  MemBack();
+
+  virtual ~MemBack();
+
+  /// Appends the Datum objects to their tables.
+  virtual void Notify(DatumList data);
+
+  /// Returns a unique name for this backend.
+  virtual std::string Name();
+
+  /// Does nothing - all data is always available.
+  virtual void Flush() {}
+
+  /// Does nothing - data remains queryable until the backend is destroyed.
+  virtual void Close() {}
+
+  virtual QueryResult Query(std::string table, std::vector<Cond>* conds);
+
+  virtual std::map<std::string, DbTypes> ColumnTypes(std::string table);
+
+  virtual std::list<ColumnInfo> Schema(std::string table);
+
+  virtual std::set<std::string> Tables();
+
+  /// Records every row held by this backend to b in a single bulk pass and
+  /// flushes it.  The stored SimId values are passed through unchanged.
+  void Export(RecBackend* b);
+
+ private:
+  typedef std::unordered_map<int, std::vector<int> > IntIndex;
+  typedef std::unordered_map<boost::uuids::uuid, std::vector<int>,
+                             boost::hash<boost::uuids::uuid> > UuidIndex;
+
+  /// A single column.  Only the vector matching the column's type is used.
+  struct Column {
+    Column() : type(INT), indexable(false), indexed(false) {}
+
+    std::string name;
+    DbTypes type;
+
+    std::vector<int> ints;
+    std::vector<char> bools;
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    std::vector<boost::uuids::uuid> uuids;
+    std::vector<std::string> strs;
+    /// blobs and container types
+    std::vector<boost::spirit::hold_any> anys;
+
+    /// true if the column is a key column that may be hash indexed.
+    bool indexable;
+
+    /// true once the index below has been built.
+    bool indexed;
+    IntIndex int_idx;
+    UuidIndex uuid_idx;
+  };
+
+  struct Table {
+    Table() : nrows(0) {}
+
+    std::vector<Column> cols;
+    int nrows;
+  };
+
+  /// Initializes an empty table with the schema of d.
+  void CreateTable(Datum* d);
+
+  /// Appends the values of d to their columns.
+  void Append(Table& t, Datum* d);
+
+  /// Builds the hash index of an indexable column.
+  void BuildIndex(Column& c);
+
+  /// Returns the rows matching an equality condition on an indexed column.
+  const std::vector<int>* Lookup(Column& c, Cond* cond);
+
+  /// returns true if row of c satisfies cond.
+  bool Match(const Column& c, int row, Cond* cond);
+
+  /// returns the value at row of c.
+  boost::spirit::hold_any Value(const Column& c, int row);
+
+  Table& GetTable(const std::string& table);
+
+  std::map<std::string, Table> tables_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_MEM_BACK_H_
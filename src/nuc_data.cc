@@ -0,0 +1,377 @@
+#include "nuc_data.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <boost/filesystem.hpp>
+
+#include "error.h"
+#include "pyne.h"
+
+namespace cyclus {
+
+/// Bounds of the direct (Z, A) slot table for ground state nuclides.
+static const int kMaxZ = 120;
+static const int kMaxA = 300;
+
+/// Marks a property that has not been fetched from pyne yet.
+static const double kUnset = -1;
+
+/// Snapshot files start with this magic string and version.  The version
+/// must be bumped whenever the layout below changes.
+static const char kSnapshotMagic[8] = "CYCNUCD";
+static const uint32_t kSnapshotVersion = 2;
+
+/// A snapshot is this header followed by, in order, the masses and decay
+/// constants (doubles), the sorted nuclide ids, the offsets of each
+/// nuclide's children (nnucs + 1 entries) and the children (32 bit ints).
+/// Doubles come first so every array is naturally aligned when mapped.
+/// The size and modification time of the nuclear data library the snapshot
+/// was compiled from are kept so that a stale snapshot can be detected.
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t nnucs;
+  uint32_t nchildren;
+  uint32_t pad;
+  uint64_t src_size;
+  int64_t src_mtime;
+};
+
+/// Reads the size and modification time of the current nuclear data library
+/// into h, leaving them zero if it can't be found.
+static void StampSource(SnapshotHeader* h) {
+  boost::system::error_code ec;
+  boost::uintmax_t size = boost::filesystem::file_size(pyne::NUC_DATA_PATH,
+                                                       ec);
+  std::time_t mtime = 0;
+  if (!ec) {
+    mtime = boost::filesystem::last_write_time(pyne::NUC_DATA_PATH, ec);
+  }
+  h->src_size = ec ? 0 : size;
+  h->src_mtime = ec ? 0 : mtime;
+}
+
+static std::size_t SnapshotSize(const SnapshotHeader& h) {
+  return sizeof(SnapshotHeader) + 2 * sizeof(double) * h.nnucs +
+         sizeof(int32_t) * h.nnucs + sizeof(uint32_t) * (h.nnucs + 1) +
+         sizeof(int32_t) * h.nchildren;
+}
+
+struct NucTables {
+  NucTables()
+      : slots(kMaxZ * kMaxA, -1),
+        data(NULL),
+        len(0),
+        nsnap(0),
+        snap_nucs(NULL),
+        snap_masses(NULL),
+        snap_decay_consts(NULL),
+        snap_child_start(NULL),
+        snap_children(NULL) {}
+
+  /// dense index of each ground state nuclide at Z * kMaxA + A, or -1.
+  std::vector<int> slots;
+
+  /// dense index of all other nuclides.
+  std::unordered_map<Nuc, int> others;
+
+  /// the loaded snapshot; its nuclides have indices [0, nsnap) and their
+  /// masses and decay constants are read directly from it.
+  const char* data;
+  std::size_t len;
+#ifdef _WIN32
+  std::vector<char> buf;
+#endif
+  int nsnap;
+  const int32_t* snap_nucs;
+  const double* snap_masses;
+  const double* snap_decay_consts;
+  const uint32_t* snap_child_start;
+  const int32_t* snap_children;
+
+  /// all other nuclides, at index nsnap + i.
+  std::vector<Nuc> nucs;
+  std::vector<double> masses;
+  std::vector<double> decay_consts;
+
+  /// children of every nuclide, copied from the snapshot or pyne on first
+  /// use.
+  std::vector<std::vector<Nuc> > children;
+  std::vector<char> children_loaded;
+};
+
+static NucTables& tables() {
+  static NucTables t;
+  return t;
+}
+
+/// Returns the slot of a ground state nuclide, or -1 if it has none.
+static int Slot(Nuc nuc) {
+  int z = nuc / 10000000;
+  int a = (nuc / 10000) % 1000;
+  if (nuc % 10000 != 0 || z < 0 || z >= kMaxZ || a >= kMaxA) {
+    return -1;
+  }
+  return z * kMaxA + a;
+}
+
+static void SetIndex(NucTables& t, Nuc nuc, int i) {
+  int slot = Slot(nuc);
+  if (slot >= 0) {
+    t.slots[slot] = i;
+  } else {
+    t.others[nuc] = i;
+  }
+}
+
+template <class T>
+static void WriteArray(std::ofstream& f, const std::vector<T>& v) {
+  if (!v.empty()) {
+    f.write(reinterpret_cast<const char*>(&v[0]), sizeof(T) * v.size());
+  }
+}
+
+static void Unmap(NucTables& t) {
+  if (t.data == NULL) {
+    return;
+  }
+#ifndef _WIN32
+  munmap(const_cast<char*>(t.data), t.len);
+#endif
+  t.data = NULL;
+}
+
+int NucData::Index(Nuc nuc) {
+  NucTables& t = tables();
+  int slot = Slot(nuc);
+  if (slot >= 0 && t.slots[slot] >= 0) {
+    return t.slots[slot];
+  } else if (slot < 0) {
+    std::unordered_map<Nuc, int>::iterator it = t.others.find(nuc);
+    if (it != t.others.end()) {
+      return it->second;
+    }
+  }
+
+  int i = t.nsnap + t.nucs.size();
+  t.nucs.push_back(nuc);
+  t.masses.push_back(kUnset);
+  t.decay_consts.push_back(kUnset);
+  t.children.push_back(std::vector<Nuc>());
+  t.children_loaded.push_back(false);
+  SetIndex(t, nuc, i);
+  return i;
+}
+
+Nuc NucData::nuc(int i) {
+  NucTables& t = tables();
+  if (i >= 0 && i < t.nsnap) {
+    return t.snap_nucs[i];
+  }
+  return t.nucs.at(i - t.nsnap);
+}
+
+int NucData::size() {
+  NucTables& t = tables();
+  return t.nsnap + t.nucs.size();
+}
+
+double NucData::atomic_mass(Nuc nuc) {
+  int i = Index(nuc);
+  NucTables& t = tables();
+  if (i < t.nsnap) {
+    return t.snap_masses[i];
+  }
+  double& m = t.masses[i - t.nsnap];
+  if (m == kUnset) {
+    m = pyne::atomic_mass(nuc);
+  }
+  return m;
+}
+
+double NucData::decay_const(Nuc nuc) {
+  int i = Index(nuc);
+  NucTables& t = tables();
+  if (i < t.nsnap) {
+    return t.snap_decay_consts[i];
+  }
+  double& lambda = t.decay_consts[i - t.nsnap];
+  if (lambda == kUnset) {
+    lambda = pyne::decay_const(nuc);
+  }
+  return lambda;
+}
+
+std::vector<Nuc> NucData::decay_children(Nuc nuc) {
+  int i = Index(nuc);
+  NucTables& t = tables();
+  if (!t.children_loaded[i]) {
+    if (i < t.nsnap) {
+      t.children[i].assign(t.snap_children + t.snap_child_start[i],
+                           t.snap_children + t.snap_child_start[i + 1]);
+    } else {
+      std::set<int> kids = pyne::decay_children(nuc);
+      t.children[i].assign(kids.begin(), kids.end());
+    }
+    t.children_loaded[i] = true;
+  }
+  return t.children[i];
+}
+
+void NucData::Clear() {
+  Unmap(tables());
+  tables() = NucTables();
+}
+
+void NucData::Compile(const std::string& path) {
+  // looking up any mass loads pyne's full atomic mass table
+  pyne::atomic_mass(10010000);
+  std::vector<int32_t> nucs;
+  std::map<int, double>::iterator it;
+  for (it = pyne::atomic_mass_map.begin(); it != pyne::atomic_mass_map.end();
+       ++it) {
+    // skip natural elements, which have no mass number
+    if (pyne::nucname::isnuclide(it->first) &&
+        pyne::nucname::anum(it->first) > 0) {
+      nucs.push_back(it->first);
+    }
+  }
+
+  std::vector<double> masses(nucs.size());
+  std::vector<double> decay_consts(nucs.size());
+  std::vector<uint32_t> child_start(1, 0);
+  std::vector<int32_t> children;
+  for (int i = 0; i < nucs.size(); ++i) {
+    masses[i] = pyne::atomic_mass(nucs[i]);
+    decay_consts[i] = pyne::decay_const(nucs[i]);
+    std::set<int> kids = pyne::decay_children(nucs[i]);
+    children.insert(children.end(), kids.begin(), kids.end());
+    child_start.push_back(children.size());
+  }
+
+  SnapshotHeader h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, kSnapshotMagic, sizeof(h.magic));
+  h.version = kSnapshotVersion;
+  h.nnucs = nucs.size();
+  h.nchildren = children.size();
+  StampSource(&h);
+
+  // other processes may have the snapshot mapped, so it is never rewritten
+  // in place: a complete new file is renamed over it instead
+  namespace fs = boost::filesystem;
+  fs::path tmp = fs::path(path).parent_path() /
+                 fs::unique_path(fs::path(path).filename().string() +
+                                 ".%%%%-%%%%-%%%%.tmp");
+  {
+    std::ofstream f(tmp.string().c_str(), std::ios::binary | std::ios::trunc);
+    if (f) {
+      f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+      WriteArray(f, masses);
+      WriteArray(f, decay_consts);
+      WriteArray(f, nucs);
+      WriteArray(f, child_start);
+      WriteArray(f, children);
+      f.close();
+    }
+    if (!f) {
+      boost::system::error_code ec;
+      fs::remove(tmp, ec);
+      throw IOError("cannot write nuclear data snapshot " + path);
+    }
+  }
+  boost::system::error_code ec;
+  fs::rename(tmp, path, ec);
+  if (ec) {
+    fs::remove(tmp, ec);
+    throw IOError("cannot write nuclear data snapshot " + path);
+  }
+}
+
+void NucData::LoadSnapshot(const std::string& path) {
+  Clear();
+  NucTables& t = tables();
+
+#ifndef _WIN32
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw IOError("cannot open nuclear data snapshot " + path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < sizeof(SnapshotHeader)) {
+    close(fd);
+    throw IOError("invalid nuclear data snapshot " + path);
+  }
+  void* mapped = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    throw IOError("cannot map nuclear data snapshot " + path);
+  }
+  t.data = static_cast<const char*>(mapped);
+  t.len = st.st_size;
+#else
+  std::ifstream f(path.c_str(), std::ios::binary);
+  if (!f) {
+    throw IOError("cannot open nuclear data snapshot " + path);
+  }
+  t.buf.assign(std::istreambuf_iterator<char>(f),
+               std::istreambuf_iterator<char>());
+  t.data = t.buf.empty() ? NULL : &t.buf[0];
+  t.len = t.buf.size();
+#endif
+
+  const SnapshotHeader* h = reinterpret_cast<const SnapshotHeader*>(t.data);
+  if (t.len < sizeof(SnapshotHeader) ||
+      memcmp(h->magic, kSnapshotMagic, sizeof(h->magic)) != 0 ||
+      h->version != kSnapshotVersion || t.len != SnapshotSize(*h)) {
+    Clear();
+    throw IOError("invalid or outdated nuclear data snapshot " + path +
+                  " - recompile it with cyclus --compile-nuc-data");
+  }
+  SnapshotHeader src;
+  StampSource(&src);
+  if (h->src_size != src.src_size || h->src_mtime != src.src_mtime) {
+    Clear();
+    throw IOError("nuclear data snapshot " + path + " is out of date with " +
+                  pyne::NUC_DATA_PATH +
+                  " - recompile it with cyclus --compile-nuc-data");
+  }
+
+  const char* p = t.data + sizeof(SnapshotHeader);
+  t.snap_masses = reinterpret_cast<const double*>(p);
+  p += sizeof(double) * h->nnucs;
+  t.snap_decay_consts = reinterpret_cast<const double*>(p);
+  p += sizeof(double) * h->nnucs;
+  t.snap_nucs = reinterpret_cast<const int32_t*>(p);
+  p += sizeof(int32_t) * h->nnucs;
+  t.snap_child_start = reinterpret_cast<const uint32_t*>(p);
+  p += sizeof(uint32_t) * (h->nnucs + 1);
+  t.snap_children = reinterpret_cast<const int32_t*>(p);
+  t.nsnap = h->nnucs;
+
+  t.children.resize(t.nsnap);
+  t.children_loaded.resize(t.nsnap, false);
+  for (int i = 0; i < t.nsnap; ++i) {
+    SetIndex(t, t.snap_nucs[i], i);
+  }
+}
+
+bool NucData::snapshot_loaded() {
+  return tables().nsnap > 0;
+}
+
+}  // namespace cyclus
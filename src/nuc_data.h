@@ -0,0 +1,69 @@
+#ifndef CYCLUS_SRC_NUC_DATA_H_
+#define CYCLUS_SRC_NUC_DATA_H_
+
+#include <string>
+#include <vector>
+
+#include "composition.h"
+
+namespace cyclus {
+
+/// Dense tables of the nuclide properties cyclus uses on hot paths (mass/atom
+/// conversions and decay checks).  Each nuclide seen is given a small dense
+/// index and its properties are stored in flat arrays at that index, so
+/// repeated lookups are array indexing rather than pyne's map and HDF5
+/// lookups.  Ground state nuclides map to their index through a direct
+/// (Z, A) slot table; other states go through a hash table.
+///
+/// Each property is fetched from pyne the first time it is requested for a
+/// nuclide, unless a precompiled snapshot (see Compile and LoadSnapshot) is
+/// loaded.  The tables are global to the process and not thread safe.
+class NucData {
+ public:
+  /// Returns the dense index of nuc, adding it to the tables if necessary.
+  static int Index(Nuc nuc);
+
+  /// Returns the nuclide with dense index i.
+  static Nuc nuc(int i);
+
+  /// Returns the number of indexed nuclides.
+  static int size();
+
+  /// Returns the atomic mass of nuc in amu (same as pyne::atomic_mass).
+  static double atomic_mass(Nuc nuc);
+
+  /// Returns the decay constant of nuc in 1/s (same as pyne::decay_const).
+  static double decay_const(Nuc nuc);
+
+  /// Returns the sorted decay children of nuc (same as pyne::decay_children).
+  /// The children are returned by value because indexing new nuclides
+  /// grows the tables.
+  static std::vector<Nuc> decay_children(Nuc nuc);
+
+  /// Removes all nuclides from the tables and unmaps any loaded snapshot,
+  /// e.g. after the nuclear data path changes.
+  static void Clear();
+
+  /// Writes a versioned binary snapshot of the properties of every nuclide
+  /// in the nuclear data library to path.  The snapshot is written to a
+  /// temporary file next to path and renamed over it, so processes that
+  /// have the old snapshot mapped keep using it.  Throws IOError if the file
+  /// can't be written.
+  static void Compile(const std::string& path);
+
+  /// Replaces the tables with the snapshot at path.  The file is mapped
+  /// read-only, so the properties of its nuclides are served straight from
+  /// pages shared by every process using the same snapshot, without opening
+  /// the HDF5 library.  Nuclides missing from the snapshot still fall back
+  /// to pyne.  Throws IOError if the file is missing, invalid, was written
+  /// by a different snapshot version or was compiled from a nuclear data
+  /// library whose size or modification time differ from the current one.
+  static void LoadSnapshot(const std::string& path);
+
+  /// Returns true if a snapshot is loaded.
+  static bool snapshot_loaded();
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_NUC_DATA_H_
@@ -1,5 +1,7 @@
 #include "product.h"
 
+#include <set>
+
 #include "error.h"
 #include "logger.h"
 
@@ -8,13 +10,13 @@ namespace cyclus {
 const ResourceType Product::kType = "Product";
 
 std::map<std::string, int> Product::qualids_;
-int Product::next_qualid_ = 1;
+IdAllocator Product::next_qualid_(1);
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Product::Ptr Product::Create(Agent* creator, double quantity,
                              std::string quality) {
   if (qualids_.count(quality) == 0) {
-    qualids_[quality] = next_qualid_++;
+    qualids_[quality] = next_qualid_.Next();
     creator->context()->NewDatum("Products")
         ->AddVal("QualId", qualids_[quality])
         ->AddVal("Quality", quality)
@@ -54,6 +56,40 @@ void Product::Absorb(Product::Ptr other) {
   tracker_.Absorb(&other->tracker_);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Product::Absorb(const std::vector<Product::Ptr>& others) {
+  // quantities are zeroed as they're absorbed, so a repeated product would
+  // be counted twice
+  std::set<Product*> seen;
+  for (int i = 0; i < others.size(); ++i) {
+    if (others[i].get() == this) {
+      throw ValueError("cannot absorb a product into itself");
+    } else if (!seen.insert(others[i].get()).second) {
+      throw ValueError("duplicate product absorb attempted");
+    }
+  }
+
+  std::vector<ResTracker*> trackers;
+  trackers.reserve(others.size());
+  for (int i = 0; i < others.size(); ++i) {
+    if (others[i]->quality() != quality()) {
+      throw ValueError("incompatible resource types.");
+    }
+    trackers.push_back(&others[i]->tracker_);
+  }
+
+  for (int i = 0; i < others.size(); ++i) {
+    quantity_ += others[i]->quantity();
+    others[i]->quantity_ = 0;
+  }
+  tracker_.Absorb(trackers);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Product::Traded() {
+  tracker_.Trade();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Product::Ptr Product::Extract(double quantity) {
   if (quantity > quantity_) {
@@ -61,6 +61,8 @@ class Product : public Resource {
 
   virtual Resource::Ptr ExtractRes(double quantity);
 
+  virtual void Traded();
+
   /// Extracts the specified mass from this resource and returns it as a
   /// new product object with the same quality/type.
   ///
@@ -71,6 +73,11 @@ class Product : public Resource {
   /// @throws ValueError 'other' resource is of different quality
   void Absorb(Product::Ptr other);
 
+  /// Absorbs all of others at once, recording a single new resource state.
+  /// @throws ValueError any of others is of different quality, is this
+  /// product or appears more than once
+  void Absorb(const std::vector<Product::Ptr>& others);
+
  private:
   /// @param ctx the simulation context
   /// @param quantity is a double indicating the quantity
@@ -79,7 +86,7 @@ class Product : public Resource {
 
   // map<quality, quality_id>
   static std::map<std::string, int> qualids_;
-  static int next_qualid_;
+  static IdAllocator next_qualid_;
 
   Context* ctx_;
   std::string quality_;
@@ -0,0 +1,33 @@
+#ifdef PYNE_DECAY_IS_DUMMY
+#ifndef PYNE_GEUP5PGEJBFGNHGI36TRBB4WGM
+#define PYNE_GEUP5PGEJBFGNHGI36TRBB4WGM
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+//              WARNING
+// This file has been auto generated
+// Do not modify directly. You have
+// been warned. This is that warning
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#include <map>
+//#include <cmath>
+
+#ifndef PYNE_IS_AMALGAMATED
+#include "data.h"
+#include "nucname.h"
+#endif
+
+namespace pyne {
+namespace decayers {
+
+extern const int all_nucs[4];
+
+std::map<int, double> decay(std::map<int, double> comp, double t);
+
+}  // namespace decayers
+}  // namespace pyne
+
+#endif  // PYNE_GEUP5PGEJBFGNHGI36TRBB4WGM
+#endif  // PYNE_DECAY_IS_DUMMY
\ No newline at end of file
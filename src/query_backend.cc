@@ -0,0 +1,78 @@
+#include "query_backend.h"
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include "error.h"
+
+namespace cyclus {
+
+typedef std::map<const std::type_info*, DbTypes, TypeInfoLess> TypeMap;
+
+static TypeMap BuildTypeMap() {
+  TypeMap m;
+  m[&typeid(int)] = INT;
+  m[&typeid(double)] = DOUBLE;
+  m[&typeid(float)] = FLOAT;
+  m[&typeid(bool)] = BOOL;
+  m[&typeid(Blob)] = BLOB;
+  m[&typeid(boost::uuids::uuid)] = UUID;
+  m[&typeid(std::string)] = STRING;
+  m[&typeid(std::set<int>)] = SET_INT;
+  m[&typeid(std::set<std::string>)] = SET_STRING;
+  m[&typeid(std::vector<int>)] = VECTOR_INT;
+  m[&typeid(std::vector<double>)] = VECTOR_DOUBLE;
+  m[&typeid(std::vector<std::string>)] = VECTOR_STRING;
+  m[&typeid(std::list<int>)] = LIST_INT;
+  m[&typeid(std::list<std::string>)] = LIST_STRING;
+  m[&typeid(std::map<int, int>)] = MAP_INT_INT;
+  m[&typeid(std::map<int, double>)] = MAP_INT_DOUBLE;
+  m[&typeid(std::map<int, std::string>)] = MAP_INT_STRING;
+  m[&typeid(std::map<std::string, int>)] = MAP_STRING_INT;
+  m[&typeid(std::map<std::string, double>)] = MAP_STRING_DOUBLE;
+  m[&typeid(std::map<std::string, std::string>)] = MAP_STRING_STRING;
+  m[&typeid(std::map<std::string, std::vector<double> >)] =
+      MAP_STRING_VECTOR_DOUBLE;
+  m[&typeid(std::map<std::string, std::map<int, double> >)] =
+      MAP_STRING_MAP_INT_DOUBLE;
+  m[&typeid(std::map<std::string,
+                     std::pair<double, std::map<int, double> > >)] =
+      MAP_STRING_PAIR_DOUBLE_MAP_INT_DOUBLE;
+  m[&typeid(std::map<int, std::map<std::string, double> >)] =
+      MAP_INT_MAP_STRING_DOUBLE;
+  m[&typeid(
+      std::map<std::string,
+               std::vector<std::pair<int, std::pair<std::string,
+                                                    std::string> > > >)] =
+      MAP_STRING_VECTOR_PAIR_INT_PAIR_STRING_STRING;
+  m[&typeid(
+      std::map<std::string,
+               std::pair<std::string, std::vector<double> > >)] =
+      MAP_STRING_PAIR_STRING_VECTOR_DOUBLE;
+  m[&typeid(std::map<std::string, std::map<std::string, int> >)] =
+      MAP_STRING_MAP_STRING_INT;
+  m[&typeid(std::list<std::pair<int, int> >)] = LIST_PAIR_INT_INT;
+  m[&typeid(
+      std::vector<std::pair<std::pair<double, double>,
+                            std::map<std::string, double> > >)] =
+      VECTOR_PAIR_PAIR_DOUBLE_DOUBLE_MAP_STRING_DOUBLE;
+  return m;
+}
+
+DbTypes DbTypeOf(const boost::spirit::hold_any& v) {
+  // built once, thread safely, on first use
+  static const TypeMap type_map = BuildTypeMap();
+  TypeMap::const_iterator it = type_map.find(&v.type());
+  if (it == type_map.end()) {
+    throw ValueError(std::string("unsupported backend type ") +
+                     v.type().name());
+  }
+  return it->second;
+}
+
+}  // namespace cyclus
@@ -5,6 +5,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <typeinfo>
 
 #include <boost/uuid/sha1.hpp>
 
@@ -553,6 +554,90 @@ class PrefixInjector: public QueryableBackend {
   std::string prefix_;
 };
 
+/// Wrapper class for QueryableBackends that reads each table once and answers
+/// queries on a single integer key field from an in-memory index.  Every
+/// table is read from the wrapped backend with the given conditions the first
+/// time it is queried; later queries whose only condition is "key == value"
+/// return the matching rows without touching the wrapped backend.  Any other
+/// query is passed through with the conditions injected.  This is useful when
+/// the same tables are queried once per agent or resource (e.g. when
+/// restarting a simulation).
+class KeyedCache: public QueryableBackend {
+ public:
+  KeyedCache(QueryableBackend* b, std::vector<Cond> conds, std::string key)
+      : b_(b),
+        conds_(conds),
+        key_(key) {}
+
+  virtual QueryResult Query(std::string table, std::vector<Cond>* conds) {
+    if (conds == NULL || conds->size() != 1 || (*conds)[0].field != key_ ||
+        (*conds)[0].opcode != EQ) {
+      std::vector<Cond> c = conds_;
+      if (conds != NULL) {
+        c.insert(c.end(), conds->begin(), conds->end());
+      }
+      return b_->Query(table, &c);
+    }
+
+    Table& t = Load(table);
+    QueryResult qr;
+    qr.fields = t.qr.fields;
+    qr.types = t.qr.types;
+    std::map<int, std::vector<int> >::iterator it =
+        t.index.find((*conds)[0].val.cast<int>());
+    if (it != t.index.end()) {
+      for (int i = 0; i < it->second.size(); ++i) {
+        qr.rows.push_back(t.qr.rows[it->second[i]]);
+      }
+    }
+    return qr;
+  }
+
+  virtual std::map<std::string, DbTypes> ColumnTypes(std::string table) {
+    return b_->ColumnTypes(table);
+  }
+
+  virtual std::list<ColumnInfo> Schema(std::string table) {
+    return b_->Schema(table);
+  }
+
+  virtual std::set<std::string> Tables() { return b_->Tables(); }
+
+ private:
+  struct Table {
+    QueryResult qr;
+    /// row numbers in qr by key value
+    std::map<int, std::vector<int> > index;
+  };
+
+  Table& Load(const std::string& table) {
+    std::map<std::string, Table>::iterator it = tables_.find(table);
+    if (it != tables_.end()) {
+      return it->second;
+    }
+
+    // a missing table throws here and is retried on the next query
+    QueryResult qr = b_->Query(table, &conds_);
+    Table& t = tables_[table];
+    t.qr = qr;
+    for (int j = 0; j < qr.fields.size(); ++j) {
+      if (qr.fields[j] != key_) {
+        continue;
+      }
+      for (int i = 0; i < qr.rows.size(); ++i) {
+        t.index[qr.rows[i][j].cast<int>()].push_back(i);
+      }
+      break;
+    }
+    return t;
+  }
+
+  QueryableBackend* b_;
+  std::vector<Cond> conds_;
+  std::string key_;
+  std::map<std::string, Table> tables_;
+};
+
 /// Compares a condiontion for a single value
 template <typename T>
 inline bool CmpCond(T* x, Cond* cond) {
@@ -596,6 +681,17 @@ inline bool CmpConds(T* x, std::vector<Cond*>* conds) {
   return true;
 }
 
+/// Orders type_info pointers by the types they describe.
+struct TypeInfoLess {
+  bool operator()(const std::type_info* a, const std::type_info* b) const {
+    return a->before(*b);
+  }
+};
+
+/// Returns the database type of the value held by v.
+/// @throws ValueError if no database type stores values of v's type
+DbTypes DbTypeOf(const boost::spirit::hold_any& v);
+
 /// The digest type for SHA1s.
 ///
 /// This class is a hack around a language deficiency in C++. You cannot pass
@@ -164,6 +164,15 @@ class RequestPortfolio
   /// doesn't already exist
   /// @param c the constraint to add
   inline void AddConstraint(const CapacityConstraint<T>& c) {
+    // constraints are ordered by id, so equal constraints (e.g., the default
+    // constraint added every time a reused portfolio is translated) have to
+    // be found by value
+    typename std::set<CapacityConstraint<T>>::const_iterator it;
+    for (it = constraints_.begin(); it != constraints_.end(); ++it) {
+      if (*it == c) {
+        return;
+      }
+    }
     constraints_.insert(c);
   }
 
@@ -9,7 +9,8 @@ ResTracker::ResTracker(Context* ctx, Resource* r)
       res_(r),
       ctx_(ctx),
       parent1_(0),
-      parent2_(0) {}
+      parent2_(0),
+      lineage_(0) {}
 
 void ResTracker::DontTrack() {
   tracked_ = false;
@@ -23,6 +24,9 @@ void ResTracker::Create(Agent* creator) {
   parent1_ = 0;
   parent2_ = 0;
   Record();
+  if (ctx_->provenance() > COMPACT_PROVENANCE) {
+    return;
+  }
   ctx_->NewDatum("ResCreators")
       ->AddVal("ResourceId", res_->state_id())
       ->AddVal("AgentId", creator->id())
@@ -49,6 +53,7 @@ void ResTracker::Extract(ResTracker* removed) {
   removed->parent1_ = res_->state_id();
   removed->parent2_ = 0;
   removed->tracked_ = tracked_;
+  removed->lineage_ = lineage_;
 
   Record();
   removed->Record();
@@ -61,24 +66,81 @@ void ResTracker::Absorb(ResTracker* absorbed) {
 
   parent1_ = res_->state_id();
   parent2_ = absorbed->res_->state_id();
+  if (lineage_ == 0) {
+    lineage_ = absorbed->lineage_;
+  }
   Record();
 }
 
+void ResTracker::Absorb(const std::vector<ResTracker*>& absorbed) {
+  if (absorbed.size() == 1) {
+    Absorb(absorbed[0]);
+    return;
+  } else if (!tracked_ || absorbed.empty()) {
+    return;
+  }
+
+  std::vector<int> parents;
+  parents.reserve(absorbed.size());
+  for (int i = 0; i < absorbed.size(); ++i) {
+    parents.push_back(absorbed[i]->res_->state_id());
+    if (lineage_ == 0) {
+      lineage_ = absorbed[i]->lineage_;
+    }
+  }
+  parent1_ = res_->state_id();
+  parent2_ = parents[0];
+  Record();
+
+  if (ctx_->provenance() <= COMPACT_PROVENANCE) {
+    ctx_->NewDatum("ResourceMerges")
+        ->AddVal("ResourceId", res_->state_id())
+        ->AddVal("Parents", parents)
+        ->Record();
+  }
+}
+
+void ResTracker::Trade() {
+  if (!tracked_ || ctx_->provenance() != TRADE_PROVENANCE ||
+      lineage_ == res_->state_id()) {
+    return;
+  }
+
+  parent1_ = lineage_;
+  parent2_ = 0;
+  lineage_ = res_->state_id();
+  RecordRow(false);
+  res_->Record(ctx_);
+}
+
 void ResTracker::Record() {
   res_->BumpStateId();
-  ctx_->NewDatum("Resources")
+  Provenance level = ctx_->provenance();
+  if (level > COMPACT_PROVENANCE) {
+    return;
+  }
+  RecordRow(level == COMPACT_PROVENANCE);
+  res_->Record(ctx_);
+}
+
+void ResTracker::RecordRow(bool compact) {
+  Datum* d = ctx_->NewDatum("Resources")
       ->AddVal("ResourceId", res_->state_id())
-      ->AddVal("ObjId", res_->obj_id())
-      ->AddVal("Type", res_->type())
-      ->AddVal("TimeCreated", ctx_->time())
-      ->AddVal("Quantity", res_->quantity())
-      ->AddVal("Units", res_->units())
-      ->AddVal("QualId", res_->qual_id())
+      ->AddVal("ObjId", res_->obj_id());
+  if (compact) {
+    d->AddVal("TypeId", ctx_->ResourceTypeId(res_->type(), res_->units()));
+  } else {
+    d->AddVal("Type", res_->type());
+  }
+  d->AddVal("TimeCreated", ctx_->time())
+      ->AddVal("Quantity", res_->quantity());
+  if (!compact) {
+    d->AddVal("Units", res_->units());
+  }
+  d->AddVal("QualId", res_->qual_id())
       ->AddVal("Parent1", parent1_)
       ->AddVal("Parent2", parent2_)
       ->Record();
-
-  res_->Record(ctx_);
 }
 
 }  // namespace cyclus
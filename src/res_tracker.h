@@ -18,7 +18,10 @@ namespace cyclus {
 /// Invocations to Create, Extract, Absorb, and Modify result in one or more
 /// entries in the output db Resource table and also call the Record method of
 /// the tracker's tracked resource.  A zero parent id indicates a resource id
-/// has no parent; if both are zeros the resource was newly created.
+/// has no parent; if both are zeros the resource was newly created.  How much
+/// of this is recorded depends on the simulation's provenance setting (see
+/// SimInfo::provenance); resource state ids are bumped the same way
+/// regardless.
 class ResTracker {
  public:
   /// Create a new tracker following r.
@@ -39,15 +42,34 @@ class ResTracker {
   /// @param absorbed the tracker of the resource being absorbed.
   void Absorb(ResTracker* absorbed);
 
+  /// Should be called when a resource is combined with several others at
+  /// once.  This records a single state whose Parent2 is the first absorbed
+  /// resource, plus one ResourceMerges row listing every absorbed state.
+  /// @param absorbed the trackers of the resources being absorbed.
+  void Absorb(const std::vector<ResTracker*>& absorbed);
+
   /// Should be called when the state of a resource changes (e.g. radioactive
   /// decay).
   void Modify();
 
+  /// Should be called when a resource is traded between agents.  Records the
+  /// resource's current state if the provenance setting is "trades".
+  void Trade();
+
  private:
+  /// Assigns the resource a new state id and records it per the provenance
+  /// setting.
   void Record();
 
+  /// Writes the Resources row for the resource's current state.
+  void RecordRow(bool compact);
+
   int parent1_;
   int parent2_;
+
+  /// the most recent state of this resource's lineage recorded with
+  /// "trades" provenance, or zero.
+  int lineage_;
   bool tracked_;
   Resource* res_;
   Context* ctx_;
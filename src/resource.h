@@ -5,6 +5,8 @@
 #include <vector>
 #include <boost/shared_ptr.hpp>
 
+#include "id_allocator.h"
+
 class SimInitTest;
 
 namespace cyclus {
@@ -23,7 +25,7 @@ class Resource {
  public:
   typedef boost::shared_ptr<Resource> Ptr;
 
-  Resource() : state_id_(nextstate_id_++), obj_id_(nextobj_id_++) {}
+  Resource() : state_id_(nextstate_id_.Next()), obj_id_(nextobj_id_.Next()) {}
 
   virtual ~Resource() {}
 
@@ -79,9 +81,14 @@ class Resource {
   /// @return a new resource object with same state id and quantity == quantity
   virtual Ptr ExtractRes(double quantity) = 0;
 
+  /// Notifies the resource that it is being transferred between agents.
+  /// Tracked resource implementations should forward this to their
+  /// ResTracker's Trade method.  This should NEVER be called by agents.
+  virtual void Traded() {}
+
  private:
-  static int nextstate_id_;
-  static int nextobj_id_;
+  static IdAllocator nextstate_id_;
+  static IdAllocator nextobj_id_;
   int state_id_;
   int obj_id_;
 };
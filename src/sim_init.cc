@@ -1,5 +1,9 @@
 #include "sim_init.h"
 
+#include <algorithm>
+
+#include <boost/lexical_cast.hpp>
+
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
 #include "prog_solver.h"
@@ -13,6 +17,16 @@ class Dummy : public Region {
   Dummy* Clone() { return NULL; }
 };
 
+/// Returns the column of field in qr.
+static int FieldIndex(const QueryResult& qr, const std::string& field) {
+  for (int i = 0; i < qr.fields.size(); ++i) {
+    if (qr.fields[i] == field) {
+      return i;
+    }
+  }
+  throw KeyError("query result has no such field " + field);
+}
+
 SimInit::SimInit() : rec_(NULL), ctx_(NULL) {}
 
 SimInit::~SimInit() {
@@ -71,6 +85,9 @@ void SimInit::InitBase(QueryableBackend* b, boost::uuids::uuid simid, int t) {
 }
 
 void SimInit::Snapshot(Context* ctx) {
+  // buffered output isn't part of the snapshot, so it is recorded first
+  ctx->FlushOutputBuffers();
+
   ctx->NewDatum("Snapshots")
      ->AddVal("Time", ctx->time())
      ->Record();
@@ -94,27 +111,27 @@ void SimInit::Snapshot(Context* ctx) {
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Transaction"))
-      ->AddVal("NextId", ctx->trans_id_)
+      ->AddVal("NextId", ctx->trans_id_.next())
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Composition"))
-      ->AddVal("NextId", Composition::next_id_)
+      ->AddVal("NextId", Composition::next_id_.next())
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("ResourceState"))
-      ->AddVal("NextId", Resource::nextstate_id_)
+      ->AddVal("NextId", Resource::nextstate_id_.next())
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("ResourceObj"))
-      ->AddVal("NextId", Resource::nextobj_id_)
+      ->AddVal("NextId", Resource::nextobj_id_.next())
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Product"))
-      ->AddVal("NextId", Product::next_qualid_)
+      ->AddVal("NextId", Product::next_qualid_.next())
       ->Record();
 }
 
@@ -142,6 +159,34 @@ void SimInit::SnapAgent(Agent* m) {
   }
 }
 
+/// Returns the TypeId -> type map of the ResourceTypes table, which only
+/// exists in databases recorded with "compact" provenance.
+static std::map<int, ResourceType> LoadResourceTypes(QueryableBackend* b) {
+  std::map<int, ResourceType> types;
+  QueryResult qr;
+  try {
+    qr = b->Query("ResourceTypes", NULL);
+  } catch (std::exception err) {
+    return types;
+  }  // table doesn't exist (okay)
+
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    types[qr.GetVal<int>("TypeId", i)] = qr.GetVal<ResourceType>("Type", i);
+  }
+  return types;
+}
+
+/// Returns the type of the resource in row i of a Resources query result,
+/// which is stored either by name or by TypeId depending on provenance.
+static ResourceType RowType(QueryResult& res, int i,
+                            std::map<int, ResourceType>& types) {
+  if (std::find(res.fields.begin(), res.fields.end(), "Type") !=
+      res.fields.end()) {
+    return res.GetVal<ResourceType>("Type", i);
+  }
+  return types[res.GetVal<int>("TypeId", i)];
+}
+
 void SimInit::LoadInfo() {
   QueryResult qr = b_->Query("Info", NULL);
   int dur = qr.GetVal<int>("Duration");
@@ -167,6 +212,11 @@ void SimInit::LoadInfo() {
   si_.explicit_inventory = qr.GetVal<bool>("RecordInventory");
   si_.explicit_inventory_compact = qr.GetVal<bool>("RecordInventoryCompact");
 
+  try {
+    qr = b_->Query("ProvenanceMode", NULL);
+    si_.provenance = qr.GetVal<std::string>("Provenance");
+  } catch (std::exception err) {}  // recorded before provenance levels (okay)
+
   ctx_->InitSim(si_);
 }
 
@@ -178,11 +228,16 @@ void SimInit::LoadRecipes() {
     return;
   }  // table doesn't exist (okay)
 
+  std::set<int> qualids;
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    qualids.insert(qr.GetVal<int>("QualId", i));
+  }
+  comps_ = LoadCompositions(b_, qualids);
+
   for (int i = 0; i < qr.rows.size(); ++i) {
     std::string recipe = qr.GetVal<std::string>("Recipe", i);
     int stateid = qr.GetVal<int>("QualId", i);
-    Composition::Ptr c = LoadComposition(b_, stateid);
-    ctx_->AddRecipe(recipe, c);
+    ctx_->AddRecipe(recipe, comps_[stateid]);
   }
 }
 
@@ -329,6 +384,22 @@ void SimInit::LoadInitialAgents() {
   std::vector<Cond> conds;
   conds.push_back(Cond("EnterTime", "<=", t_));
   QueryResult qentry = b_->Query("AgentEntry", &conds);
+
+  std::set<int> exited;  // agents decommissioned before t_
+  conds.clear();
+  conds.push_back(Cond("ExitTime", "<", t_));
+  try {
+    QueryResult qexit = b_->Query("AgentExit", &conds);
+    for (int i = 0; i < qexit.rows.size(); ++i) {
+      exited.insert(qexit.GetVal<int>("AgentId", i));
+    }
+  } catch (std::exception err) {}  // table doesn't exist (okay)
+
+  // every agent state table is read once for all agents at t_
+  conds.clear();
+  conds.push_back(Cond("SimTime", "==", t_));
+  KeyedCache states(b_, conds, "AgentId");
+
   std::map<int, int> parentmap;  // map<agentid, parentid>
   std::map<int, Agent*> unbuilt;  // map<agentid, agent_ptr>
   for (int i = 0; i < qentry.rows.size(); ++i) {
@@ -337,15 +408,9 @@ void SimInit::LoadInitialAgents() {
       continue;
     }
     int id = qentry.GetVal<int>("AgentId", i);
-    std::vector<Cond> conds;
-    conds.push_back(Cond("AgentId", "==", id));
-    conds.push_back(Cond("ExitTime", "<", t_));
-    try {
-      QueryResult qexit = b_->Query("AgentExit", &conds);
-      if (qexit.rows.size() != 0) {
-        continue;  // agent was decomissioned before t_ - skip
-      }
-    } catch (std::exception err) {}  // table doesn't exist (okay)
+    if (exited.count(id) != 0) {
+      continue;  // agent was decomissioned before t_ - skip
+    }
 
     // if the agent wasn't decommissioned before t_ create and init it
 
@@ -362,9 +427,9 @@ void SimInit::LoadInitialAgents() {
     parentmap[id] = qentry.GetVal<int>("ParentId", i);
 
     // agent-custom init
-    conds.pop_back();
-    conds.push_back(Cond("SimTime", "==", t_));
-    CondInjector ci(b_, conds);
+    std::vector<Cond> conds;
+    conds.push_back(Cond("AgentId", "==", id));
+    CondInjector ci(&states, conds);
     PrefixInjector pi(&ci, "AgentState");
     m->Agent::InitFrom(&pi);
     pi = PrefixInjector(&ci, "AgentState" + spec.Sanitize());
@@ -407,25 +472,127 @@ void SimInit::LoadInitialAgents() {
 }
 
 void SimInit::LoadInventories() {
+  std::vector<Cond> conds;
+  conds.push_back(Cond("SimTime", "==", t_));
+  QueryResult qr;
+  try {
+    qr = b_->Query("AgentStateInventories", &conds);
+  } catch (std::exception err) {return;}  // table doesn't exist (okay)
+
+  std::map<int, std::vector<int> > agent_rows;  // map<agentid, rows of qr>
+  std::set<int> resids;
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    agent_rows[qr.GetVal<int>("AgentId", i)].push_back(i);
+    resids.insert(qr.GetVal<int>("ResourceId", i));
+  }
+
+  if (!resids.empty() && ctx_->provenance() > COMPACT_PROVENANCE) {
+    throw IOError("cannot restore agent inventories from a simulation "
+                  "recorded with '" + si_.provenance + "' provenance");
+  }
+
+  ResourceIndex idx;
+  LoadResourceIndex(resids, &idx);
+
+  Agent* dummy = new Dummy(ctx_);
   std::map<int, Agent*>::iterator it;
   for (it = agents_.begin(); it != agents_.end(); ++it) {
     Agent* m = it->second;
-    std::vector<Cond> conds;
-    conds.push_back(Cond("SimTime", "==", t_));
-    conds.push_back(Cond("AgentId", "==", m->id()));
-    QueryResult qr;
-    try {
-      qr = b_->Query("AgentStateInventories", &conds);
-    } catch (std::exception err) {return;}  // table doesn't exist (okay)
-
+    std::vector<int>& rows = agent_rows[m->id()];
     Inventories invs;
-    for (int i = 0; i < qr.rows.size(); ++i) {
-      std::string inv_name = qr.GetVal<std::string>("InventoryName", i);
-      int state_id = qr.GetVal<int>("ResourceId", i);
-      invs[inv_name].push_back(LoadResource(ctx_, b_, state_id));
+    for (int i = 0; i < rows.size(); ++i) {
+      std::string inv_name = qr.GetVal<std::string>("InventoryName", rows[i]);
+      int state_id = qr.GetVal<int>("ResourceId", rows[i]);
+      invs[inv_name].push_back(BuildResource(idx, dummy, state_id));
     }
     m->InitInv(invs);
   }
+  ctx_->DelAgent(dummy);
+}
+
+void SimInit::LoadResourceIndex(const std::set<int>& resids,
+                                ResourceIndex* idx) {
+  if (resids.empty()) {
+    return;
+  }
+
+  std::vector<Cond> conds;
+  conds.push_back(Cond("TimeCreated", "<=", t_));
+  idx->res = b_->Query("Resources", &conds);
+  idx->types = LoadResourceTypes(b_);
+
+  bool has_mats = false;
+  std::set<int> comp_ids;  // compositions not loaded yet
+  std::set<int> prod_ids;
+  for (int i = 0; i < idx->res.rows.size(); ++i) {
+    int id = idx->res.GetVal<int>("ResourceId", i);
+    if (resids.count(id) == 0) {
+      continue;
+    }
+    idx->rows[id] = i;
+    int qualid = idx->res.GetVal<int>("QualId", i);
+    if (RowType(idx->res, i, idx->types) != Material::kType) {
+      prod_ids.insert(qualid);
+      continue;
+    }
+    has_mats = true;
+    if (comps_.count(qualid) == 0) {
+      comp_ids.insert(qualid);
+    }
+  }
+
+  if (has_mats) {
+    QueryResult qr = b_->Query("MaterialInfo", NULL);
+    for (int i = 0; i < qr.rows.size(); ++i) {
+      int id = qr.GetVal<int>("ResourceId", i);
+      if (idx->rows.count(id) != 0) {
+        idx->prev_decay[id] = qr.GetVal<int>("PrevDecayTime", i);
+      }
+    }
+    std::map<int, Composition::Ptr> comps = LoadCompositions(b_, comp_ids);
+    comps_.insert(comps.begin(), comps.end());
+  }
+
+  if (!prod_ids.empty()) {
+    QueryResult qr = b_->Query("Products", NULL);
+    for (int i = 0; i < qr.rows.size(); ++i) {
+      int qualid = qr.GetVal<int>("QualId", i);
+      if (prod_ids.count(qualid) != 0) {
+        idx->qualities[qualid] = qr.GetVal<std::string>("Quality", i);
+      }
+    }
+  }
+}
+
+Resource::Ptr SimInit::BuildResource(ResourceIndex& idx, Agent* creator,
+                                     int resid) {
+  std::map<int, int>::iterator row = idx.rows.find(resid);
+  if (row == idx.rows.end()) {
+    throw IOError("Invalid resource id in output database: " +
+                  boost::lexical_cast<std::string>(resid));
+  }
+  QueryResult& res = idx.res;
+  ResourceType type = RowType(res, row->second, idx.types);
+  double qty = res.GetVal<double>("Quantity", row->second);
+  int qualid = res.GetVal<int>("QualId", row->second);
+
+  Resource::Ptr r;
+  if (type == Material::kType) {
+    Material::Ptr mat = Material::Create(creator, qty, comps_[qualid]);
+    mat->prev_decay_time_ = idx.prev_decay[resid];
+    r = mat;
+  } else if (type == Product::kType) {
+    std::string quality = idx.qualities[qualid];
+    // set static quality-stateid map to have same vals as db
+    Product::qualids_[quality] = qualid;
+    r = Product::Create(creator, qty, quality);
+  } else {
+    throw IOError("Invalid resource type in output database: " + type);
+  }
+
+  r->state_id_ = resid;
+  r->obj_id_ = res.GetVal<int>("ObjId", row->second);
+  return r;
 }
 
 void SimInit::LoadBuildSched() {
@@ -468,15 +635,15 @@ void SimInit::LoadNextIds() {
     if (obj == "Agent") {
       Agent::next_id_ = qr.GetVal<int>("NextId", i);
     } else if (obj == "Transaction") {
-      ctx_->trans_id_ = qr.GetVal<int>("NextId", i);
+      ctx_->trans_id_.next(qr.GetVal<int>("NextId", i));
     } else if (obj == "Composition") {
-      Composition::next_id_ = qr.GetVal<int>("NextId", i);
+      Composition::next_id_.next(qr.GetVal<int>("NextId", i));
     } else if (obj == "ResourceState") {
-      Resource::nextstate_id_ = qr.GetVal<int>("NextId", i);
+      Resource::nextstate_id_.next(qr.GetVal<int>("NextId", i));
     } else if (obj == "ResourceObj") {
-      Resource::nextobj_id_ = qr.GetVal<int>("NextId", i);
+      Resource::nextobj_id_.next(qr.GetVal<int>("NextId", i));
     } else if (obj == "Product") {
-      Product::next_qualid_ = qr.GetVal<int>("NextId", i);
+      Product::next_qualid_.next(qr.GetVal<int>("NextId", i));
     } else {
       throw IOError("Unexpected value in NextIds table: " + obj);
     }
@@ -515,7 +682,8 @@ Resource::Ptr SimInit::LoadResource(Context* ctx, QueryableBackend* b, int state
   std::vector<Cond> conds;
   conds.push_back(Cond("ResourceId", "==", state_id));
   QueryResult qr = b->Query("Resources", &conds);
-  ResourceType type = qr.GetVal<ResourceType>("Type");
+  std::map<int, ResourceType> types = LoadResourceTypes(b);
+  ResourceType type = RowType(qr, 0, types);
   int obj_id = qr.GetVal<int>("ObjId");
 
   Resource::Ptr r;
@@ -566,12 +734,47 @@ Composition::Ptr SimInit::LoadComposition(QueryableBackend* b, int stateid) {
     double mass_frac = qr.GetVal<double>("MassFrac", i);
     cm[nucid] = mass_frac;
   }
-  Composition::Ptr c = Composition::CreateFromMass(cm);
+  // not interned - loaded compositions keep their database id and exact
+  // quantities even if an equal composition is live in this process
+  Composition::Ptr c(new Composition());
+  c->mass_ = cm;
   c->recorded_ = true;
   c->id_ = stateid;
   return c;
 }
 
+std::map<int, Composition::Ptr> SimInit::LoadCompositions(
+    QueryableBackend* b, const std::set<int>& qualids) {
+  std::map<int, Composition::Ptr> comps;
+  if (qualids.empty()) {
+    return comps;
+  }
+
+  // a single pass over the table gathers the nuclides of every composition
+  QueryResult qr = b->Query("Compositions", NULL);
+  int qual_col = FieldIndex(qr, "QualId");
+  int nuc_col = FieldIndex(qr, "NucId");
+  int frac_col = FieldIndex(qr, "MassFrac");
+  std::map<int, CompMap> cms;
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    const QueryRow& row = qr.rows[i];
+    int qualid = row[qual_col].cast<int>();
+    if (qualids.count(qualid) != 0) {
+      cms[qualid][row[nuc_col].cast<int>()] = row[frac_col].cast<double>();
+    }
+  }
+
+  std::set<int>::const_iterator it;
+  for (it = qualids.begin(); it != qualids.end(); ++it) {
+    Composition::Ptr c(new Composition());
+    c->mass_ = cms[*it];
+    c->recorded_ = true;
+    c->id_ = *it;
+    comps[*it] = c;
+  }
+  return comps;
+}
+
 Product::Ptr SimInit::LoadProduct(Context* ctx, QueryableBackend* b, int state_id) {
   // get general resource object info
   std::vector<Cond> conds;
@@ -96,9 +96,39 @@ class SimInit {
   static Product::Ptr LoadProduct(Context* ctx, QueryableBackend* b, int resid);
   static Composition::Ptr LoadComposition(QueryableBackend* b, int stateid);
 
+  /// Reads the Compositions table once and builds the compositions with the
+  /// given qual ids, keyed by qual id.  Equal qual ids share one object.
+  static std::map<int, Composition::Ptr> LoadCompositions(
+      QueryableBackend* b, const std::set<int>& qualids);
+
+  /// Rows of the resource tables needed to rebuild agent inventories, each
+  /// table read with a single query and indexed by id.
+  struct ResourceIndex {
+    /// rows of the Resources table
+    QueryResult res;
+    /// ResourceId -> row of res
+    std::map<int, int> rows;
+    /// ResourceId -> PrevDecayTime of materials
+    std::map<int, int> prev_decay;
+    /// QualId -> quality of products
+    std::map<int, std::string> qualities;
+    /// TypeId -> resource type, for Resources recorded with "compact"
+    /// provenance
+    std::map<int, ResourceType> types;
+  };
+
+  /// Loads the rows describing the resources with the given state ids.
+  void LoadResourceIndex(const std::set<int>& resids, ResourceIndex* idx);
+
+  /// Builds the resource with state id resid from rows loaded into idx.
+  Resource::Ptr BuildResource(ResourceIndex& idx, Agent* creator, int resid);
+
   // std::map<AgentId, Agent*>
   std::map<int, Agent*> agents_;
 
+  // std::map<QualId, Composition::Ptr> of all loaded compositions
+  std::map<int, Composition::Ptr> comps_;
+
   Context* ctx_;
   Recorder* rec_;
   Timer ti_;
@@ -1,5 +1,6 @@
 #include "sqlite_back.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -25,6 +26,13 @@
 
 namespace cyclus {
 
+/// names of the key columns that are indexed according to the index policy.
+static const char* kIndexFields[] = {"SimId", "ResourceId", "AgentId",
+                                     "QualId", "Time"};
+
+/// default maximum number of parameters in an sqlite statement.
+static const int kMaxBindParams = 999;
+
 std::vector<std::string> split(const std::string& s, char delim) {
   std::vector<std::string> elems;
   std::stringstream ss(s);
@@ -38,18 +46,39 @@ std::vector<std::string> split(const std::string& s, char delim) {
 SqliteBack::~SqliteBack() {
   try {
     Flush();
+    Close();
+  } catch (Error err) {
+    CLOG(LEV_ERROR) << "Error in SqliteBack destructor: " << err.what();
+  }
+  StopWriter();
+
+  try {
+    query_stmts_.clear();
+    multi_stmts_.clear();
+    stmts_.clear();
     db_.close();
   } catch (Error err) {
     CLOG(LEV_ERROR) << "Error in SqliteBack destructor: " << err.what();
   }
 }
 
-SqliteBack::SqliteBack(std::string path) : db_(path) {
+SqliteBack::SqliteBack(std::string path, bool background_writes)
+    : db_(path),
+      index_policy_(INDEX_NONE),
+      background_writes_(background_writes),
+      writing_(false),
+      stop_(false) {
   path_ = path;
   db_.open();
 
   db_.Execute("PRAGMA synchronous=OFF;");
-  db_.Execute("PRAGMA journal_mode=MEMORY;");
+  if (background_writes_) {
+    // lets readers in other processes see committed batches while the
+    // writer thread holds a write transaction open
+    db_.Execute("PRAGMA journal_mode=WAL;");
+  } else {
+    db_.Execute("PRAGMA journal_mode=MEMORY;");
+  }
   db_.Execute("PRAGMA temp_store=MEMORY;");
 
   // cache pre-existing table names
@@ -65,30 +94,77 @@ SqliteBack::SqliteBack(std::string path) : db_(path) {
     cmd += "(TableName TEXT,Field TEXT,Type INTEGER);";
     db_.Execute(cmd);
   }
+
+  if (background_writes_) {
+    writer_ = std::thread(&SqliteBack::WriteLoop, this);
+  }
 }
 
 void SqliteBack::Notify(DatumList data) {
-  db_.Execute("BEGIN TRANSACTION;");
-  try {
-    for (DatumList::iterator it = data.begin(); it != data.end(); ++it) {
-      std::string tbl = (*it)->title();
-      if (tbl_names_.count(tbl) == 0) {
-        CreateTable(*it);
+  if (background_writes_) {
+    // the recorder reuses its Datum objects, so the writer gets copies.
+    // Every batch carries the field names of each of its tables, so a table
+    // can still be created if writing an earlier batch failed.
+    Batch b(data.size());
+    std::set<std::string> titles;
+    for (int i = 0; i < data.size(); ++i) {
+      Row& r = b[i];
+      r.title = data[i]->title();
+      if (titles.insert(r.title).second) {
+        r.fields = data[i]->fields();
       }
-      if (stmts_.count(tbl) == 0) {
-        BuildStmt(*it);
-      }
-      WriteDatum(*it);
+      r.vals = data[i]->vals();
     }
-  } catch (ValueError err) {
-    db_.Execute("END TRANSACTION;");
-    throw ValueError(err.what());
+
+    std::unique_lock<std::mutex> lock(mu_);
+    while (queue_.size() >= kMaxQueuedBatches) {
+      written_.wait(lock);
+    }
+    ThrowWriteErr();
+    queue_.push_back(Batch());
+    queue_.back().swap(b);
+    queued_.notify_one();
+    return;
   }
-  db_.Execute("END TRANSACTION;");
-  Flush();
+
+  std::map<std::string, TableRows> tables;
+  for (DatumList::iterator it = data.begin(); it != data.end(); ++it) {
+    TableRows& t = tables[(*it)->title()];
+    if (t.fields == NULL) {
+      t.fields = &(*it)->fields();
+    }
+    t.rows.push_back(&(*it)->vals());
+  }
+  WriteTables(tables);
 }
 
-void SqliteBack::Flush() { }
+void SqliteBack::Flush() {
+  if (!background_writes_) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mu_);
+  while (!queue_.empty() || writing_) {
+    written_.wait(lock);
+  }
+  ThrowWriteErr();
+}
+
+void SqliteBack::Close() {
+  Flush();
+  if (index_policy_ != INDEX_ON_CLOSE) {
+    return;
+  }
+  std::set<std::string>::iterator it;
+  for (it = tbl_names_.begin(); it != tbl_names_.end(); ++it) {
+    if (*it == "FieldTypes") {
+      continue;
+    }
+    QueryResult info = GetTableInfo(*it);
+    for (int i = 0; i < info.fields.size(); ++i) {
+      IndexKey(*it, info.fields[i]);
+    }
+  }
+}
 
 std::list<ColumnInfo> SqliteBack::Schema(std::string table) { 
   std::list<ColumnInfo> schema;
@@ -113,11 +189,14 @@ QueryResult SqliteBack::Query(std::string table, std::vector<Cond>* conds) {
       }
       Cond c = (*conds)[i];
       sql << c.field << " " << c.op << " ?";
+      if (index_policy_ == INDEX_ON_QUERY) {
+        IndexKey(table, c.field);
+      }
     }
   }
   sql << ";";
 
-  SqlStatement::Ptr stmt = db_.Prepare(sql.str());
+  SqlStatement::Ptr stmt = CachedPrepare(sql.str());
 
   if (conds != NULL) {
     for (int i = 0; i < conds->size(); ++i) {
@@ -147,6 +226,7 @@ std::map<std::string, DbTypes> SqliteBack::ColumnTypes(std::string table) {
 std::set<std::string> SqliteBack::Tables() {
   using std::set;
   using std::string;
+  Flush();
   set<string> rtn;
   std::string sql = "SELECT name FROM sqlite_master WHERE type='table';";
   SqlStatement::Ptr stmt;
@@ -162,7 +242,49 @@ SqliteDb& SqliteBack::db() {
   return db_;
 }
 
+SqlStatement::Ptr SqliteBack::CachedPrepare(const std::string& sql) {
+  std::map<std::string, CachedStmt>::iterator it = query_stmts_.find(sql);
+  if (it != query_stmts_.end()) {
+    query_lru_.splice(query_lru_.begin(), query_lru_, it->second.second);
+    SqlStatement::Ptr stmt = it->second.first;
+    stmt->Reset();
+    return stmt;
+  }
+
+  if (query_stmts_.size() >= kQueryCacheSize) {
+    query_stmts_.erase(query_lru_.back());
+    query_lru_.pop_back();
+  }
+  SqlStatement::Ptr stmt = db_.Prepare(sql);
+  query_lru_.push_front(sql);
+  query_stmts_[sql] = CachedStmt(stmt, query_lru_.begin());
+  return stmt;
+}
+
+void SqliteBack::IndexKey(const std::string& table, const std::string& field) {
+  std::string key = table + "." + field;
+  if (indexed_.count(key) > 0) {
+    return;
+  }
+
+  int nfields = sizeof(kIndexFields) / sizeof(kIndexFields[0]);
+  for (int i = 0; i < nfields; ++i) {
+    if (field == kIndexFields[i]) {
+      db_.Execute("CREATE INDEX IF NOT EXISTS " + table + "_" + field +
+                  " ON " + table + " (" + field + ");");
+      break;
+    }
+  }
+  indexed_.insert(key);
+}
+
 QueryResult SqliteBack::GetTableInfo(std::string table) {
+  Flush();
+  std::map<std::string, QueryResult>::iterator cached = infos_.find(table);
+  if (cached != infos_.end()) {
+    return cached->second;
+  }
+
   std::string sql = "SELECT Field,Type FROM FieldTypes WHERE TableName = '" +
                     table + "';";
   SqlStatement::Ptr stmt;
@@ -177,6 +299,7 @@ QueryResult SqliteBack::GetTableInfo(std::string table) {
   if (i == 0) {
     throw ValueError("Invalid table name " + table);
   }
+  infos_[table] = info;
   return info;
 }
 
@@ -184,69 +307,183 @@ std::string SqliteBack::Name() {
   return path_;
 }
 
-void SqliteBack::BuildStmt(Datum* d) {
-  std::string name = d->title();
-  Datum::Vals vals = d->vals();
+void SqliteBack::BuildStmt(const std::string& name,
+                           const Datum::Vals& vals) {
   std::vector<DbTypes> schema;
 
   schema.push_back(Type(vals[0].second));
-  std::string insert = "INSERT INTO " + name + " VALUES (?";
+  std::string row = "(?";
   for (int i = 1; i < vals.size(); ++i) {
     schema.push_back(Type(vals[i].second));
-    insert += ", ?";
+    row += ", ?";
   }
-  insert += ");";
+  row += ")";
 
   schemas_[name] = schema;
-  stmts_[name] = db_.Prepare(insert);
-}
+  stmts_[name] = db_.Prepare("INSERT INTO " + name + " VALUES " + row + ";");
 
-void SqliteBack::CreateTable(Datum* d) {
-  std::string name = d->title();
-  tbl_names_.insert(name);
-
-  Datum::Vals vals = d->vals();
-  Datum::Vals::iterator it = vals.begin();
-
-  std::stringstream types;
-  types << "INSERT INTO FieldTypes VALUES ('"
-        << name << "','" << it->first << "','"
-        << Type(it->second) << "');";
-  db_.Execute(types.str());
+  int nrows = std::min<int>(kMaxInsertRows, kMaxBindParams / vals.size());
+  if (nrows > 1) {
+    std::string insert = "INSERT INTO " + name + " VALUES " + row;
+    for (int i = 1; i < nrows; ++i) {
+      insert += ", " + row;
+    }
+    insert += ";";
+    multi_stmts_[name] = std::make_pair(db_.Prepare(insert), nrows);
+  }
+}
 
+void SqliteBack::CreateTable(const std::string& name,
+                             const Datum::Fields& fields,
+                             const Datum::Vals& vals) {
   std::string cmd = "CREATE TABLE " + name + " (";
-  cmd += std::string(it->first) + " " + SqlType(it->second);
-  ++it;
+  for (int i = 0; i < fields.size(); ++i) {
+    if (i > 0) {
+      cmd += ", ";
+    }
+    cmd += fields[i] + " " + SqlType(vals[i].second);
+  }
+  cmd += ");";
+  db_.Execute(cmd);
 
-  while (it != vals.end()) {
-    cmd += ", " + std::string(it->first) + " " + SqlType(it->second);
+  for (int i = 0; i < fields.size(); ++i) {
     std::stringstream types;
     types << "INSERT INTO FieldTypes VALUES ('"
-          << name << "','" << it->first << "','"
-          << Type(it->second) << "');";
+          << name << "','" << fields[i] << "','"
+          << Type(vals[i].second) << "');";
     db_.Execute(types.str());
-    ++it;
   }
+  tbl_names_.insert(name);
+}
 
-  cmd += ");";
-  db_.Execute(cmd);
+void SqliteBack::WriteTables(std::map<std::string, TableRows>& tables) {
+  db_.Execute("BEGIN TRANSACTION;");
+  try {
+    std::map<std::string, TableRows>::iterator it;
+    for (it = tables.begin(); it != tables.end(); ++it) {
+      const std::string& tbl = it->first;
+      const Datum::Vals& first = *it->second.rows[0];
+      if (tbl_names_.count(tbl) == 0) {
+        CreateTable(tbl, *it->second.fields, first);
+      }
+      if (stmts_.count(tbl) == 0) {
+        BuildStmt(tbl, first);
+      }
+      WriteRows(tbl, it->second);
+    }
+  } catch (...) {
+    // close the transaction so the next batch can start its own
+    db_.Execute("END TRANSACTION;");
+    throw;
+  }
+  db_.Execute("END TRANSACTION;");
 }
 
-void SqliteBack::WriteDatum(Datum* d) {
-  Datum::Vals vals = d->vals();
-  SqlStatement::Ptr stmt = stmts_[d->title()];
-  std::vector<DbTypes> schema = schemas_[d->title()];
+void SqliteBack::WriteRows(const std::string& name, const TableRows& t) {
+  const std::vector<DbTypes>& schema = schemas_[name];
+  int ncols = schema.size();
+  int n = t.rows.size();
+  int i = 0;
 
-  for (int i = 0; i < vals.size(); ++i) {
-    boost::spirit::hold_any v = vals[i].second;
-    Bind(v, schema[i], stmt, i+1);
+  std::map<std::string, std::pair<SqlStatement::Ptr, int> >::iterator multi =
+      multi_stmts_.find(name);
+  if (multi != multi_stmts_.end()) {
+    SqlStatement::Ptr stmt = multi->second.first;
+    int k = multi->second.second;
+    for (; n - i >= k; i += k) {
+      // rows missing fields are left to the single row statement below
+      bool full = true;
+      for (int r = 0; r < k && full; ++r) {
+        full = t.rows[i + r]->size() == ncols;
+      }
+      if (!full) {
+        break;
+      }
+
+      for (int r = 0; r < k; ++r) {
+        const Datum::Vals& vals = *t.rows[i + r];
+        for (int j = 0; j < ncols; ++j) {
+          Bind(vals[j].second, schema[j], stmt, r * ncols + j + 1);
+        }
+      }
+      stmt->Exec();
+    }
   }
 
-  stmt->Exec();
+  SqlStatement::Ptr stmt = stmts_[name];
+  for (; i < n; ++i) {
+    const Datum::Vals& vals = *t.rows[i];
+    for (int j = 0; j < vals.size(); ++j) {
+      Bind(vals[j].second, schema[j], stmt, j + 1);
+    }
+    stmt->Exec();
+  }
+}
+
+void SqliteBack::WriteLoop() {
+  std::unique_lock<std::mutex> lock(mu_);
+  while (true) {
+    while (queue_.empty() && !stop_) {
+      queued_.wait(lock);
+    }
+    if (queue_.empty()) {
+      return;
+    }
+
+    Batch b;
+    b.swap(queue_.front());
+    queue_.pop_front();
+    writing_ = true;
+    lock.unlock();
+
+    std::map<std::string, TableRows> tables;
+    for (int i = 0; i < b.size(); ++i) {
+      TableRows& t = tables[b[i].title];
+      if (!b[i].fields.empty()) {
+        t.fields = &b[i].fields;
+      }
+      t.rows.push_back(&b[i].vals);
+    }
+
+    std::string err;
+    try {
+      WriteTables(tables);
+    } catch (std::exception& e) {
+      err = e.what();
+    }
+
+    lock.lock();
+    writing_ = false;
+    if (!err.empty() && write_err_.empty()) {
+      write_err_ = err;
+    }
+    written_.notify_all();
+  }
+}
+
+void SqliteBack::StopWriter() {
+  if (!writer_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  queued_.notify_one();
+  writer_.join();
+}
+
+void SqliteBack::ThrowWriteErr() {
+  if (write_err_.empty()) {
+    return;
+  }
+  std::string msg = write_err_;
+  write_err_.clear();
+  throw IOError("background write to " + path_ + " failed: " + msg);
 }
 
-void SqliteBack::Bind(boost::spirit::hold_any v, DbTypes type, SqlStatement::Ptr stmt,
-                      int index) {
+void SqliteBack::Bind(const boost::spirit::hold_any& v, DbTypes type,
+                      SqlStatement::Ptr stmt, int index) {
 
 // serializes the value v of type T and DBType D and binds it to stmt (inside
 // a case statement
@@ -1,9 +1,15 @@
 #ifndef CYCLUS_SRC_SQLITE_BACK_H_
 #define CYCLUS_SRC_SQLITE_BACK_H_
 
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
 #include <string>
 #include <map>
 #include <set>
+#include <thread>
+#include <vector>
 
 #include "query_backend.h"
 #include "sqlite_db.h"
@@ -14,27 +20,73 @@ namespace cyclus {
 /// named Datum objects have their data placed as rows in a single table.  Handles the
 /// following datum value types: int, float, double, std::string, cyclus::Blob.
 /// Unsupported value types are stored as an empty string.
+///
+/// Rows of the same table within a Notify batch are written with multi-row
+/// INSERT statements.  If background writes are enabled, the database is put
+/// in WAL mode and batches are written by a separate writer thread: Notify
+/// only copies the batch and returns, and other processes (e.g. dashboards)
+/// can read the database while the simulation runs.  Flush, Close and all
+/// queries wait for the writer to finish the pending batches first.
 class SqliteBack: public FullBackend {
  public:
+  /// Controls when indexes are created on the key columns (SimId, ResourceId,
+  /// AgentId, QualId and Time) of the tables in the database.
+  enum IndexPolicy {
+    /// never create indexes (default).
+    INDEX_NONE = 0,
+    /// index a key column of a table the first time a query filters on it.
+    INDEX_ON_QUERY,
+    /// index the key columns of every table when the backend is closed.
+    INDEX_ON_CLOSE,
+  };
+
+  /// Number of prepared query statements kept for reuse.
+  static const int kQueryCacheSize = 64;
+
+  /// Maximum number of rows bound to a single INSERT statement.
+  static const int kMaxInsertRows = 128;
+
+  /// Maximum number of batches queued for the writer thread before Notify
+  /// blocks.
+  static const int kMaxQueuedBatches = 4;
+
   /// Creates a new sqlite backend that will write to the database file
   /// specified by path. If the file doesn't exist, a new one is created.
   /// @param path the filepath (including name) to write the sqlite file.
-  SqliteBack(std::string path);
+  /// @param background_writes if true, write in WAL mode from a separate
+  /// writer thread.
+  SqliteBack(std::string path, bool background_writes = false);
 
   virtual ~SqliteBack();
 
-  /// Writes Datum objects immediately to the database as a single transaction.
+  /// Writes Datum objects to the database as a single transaction.  With
+  /// background writes, the data is copied and queued for the writer thread
+  /// instead.
   /// @param data group of Datum objects to write to the database together.
   virtual void Notify(DatumList data);
 
   /// Returns a unique name for this backend.
   std::string Name();
 
-  /// Executes all pending commands.
+  /// Waits until all queued batches have been written.  Throws an IOError if
+  /// the writer thread failed to write a batch.
   void Flush();
 
-  /// Closes the backend, if approriate.
-  void Close() {};
+  /// Closes the backend, writing all queued batches and creating key column
+  /// indexes if the index policy is INDEX_ON_CLOSE.
+  void Close();
+
+  /// Sets when indexes are created on key columns.  Indexing makes point
+  /// lookups (e.g. ResourceId == x when restarting a simulation) logarithmic
+  /// instead of full table scans, at the cost of slower inserts into indexed
+  /// tables.
+  void index_policy(IndexPolicy p) { index_policy_ = p; }
+
+  /// Returns when indexes are created on key columns.
+  IndexPolicy index_policy() { return index_policy_; }
+
+  /// Returns true if batches are written by a separate writer thread.
+  bool background_writes() { return background_writes_; }
 
   virtual QueryResult Query(std::string table, std::vector<Cond>* conds);
 
@@ -43,13 +95,21 @@ class SqliteBack: public FullBackend {
   virtual std::set<std::string> Tables();
 
   /// Returns the underlying sqlite database. Only use this if you really know
-  /// what you are doing.
+  /// what you are doing.  With background writes, call Flush first.
   SqliteDb& db();
 
  private:
-  void Bind(boost::spirit::hold_any v, DbTypes type, SqlStatement::Ptr stmt, int index);
+  void Bind(const boost::spirit::hold_any& v, DbTypes type,
+            SqlStatement::Ptr stmt, int index);
 
   QueryResult GetTableInfo(std::string table);
+
+  /// Returns a prepared statement for sql, reusing a cached one if the same
+  /// query shape was prepared recently.
+  SqlStatement::Ptr CachedPrepare(const std::string& sql);
+
+  /// Creates an index on field of table if field is a key column without one.
+  void IndexKey(const std::string& table, const std::string& field);
   
   std::list<ColumnInfo> Schema(std::string table);
 
@@ -63,13 +123,46 @@ class SqliteBack: public FullBackend {
   /// supported sqlite datatype type in a hold_any object.
   boost::spirit::hold_any ColAsVal(SqlStatement::Ptr stmt, int col, DbTypes type);
 
-  /// Queue up a table-create command for d.
-  void CreateTable(Datum* d);
+  /// A copy of a recorded Datum that can be handed to the writer thread.
+  /// Only the first row of each table in a batch carries its field names;
+  /// the names in vals are not used.
+  struct Row {
+    std::string title;
+    Datum::Fields fields;
+    Datum::Vals vals;
+  };
+  typedef std::vector<Row> Batch;
+
+  /// Rows of one table in recorded order, with the field names of the first.
+  struct TableRows {
+    TableRows() : fields(NULL) {}
 
-  void BuildStmt(Datum* d);
+    const Datum::Fields* fields;
+    std::vector<const Datum::Vals*> rows;
+  };
 
-  /// constructs an SQL INSERT command for d and queues it for db insertion.
-  void WriteDatum(Datum* d);
+  /// Queue up a table-create command for the table name.
+  void CreateTable(const std::string& name, const Datum::Fields& fields,
+                   const Datum::Vals& vals);
+
+  /// Prepares the single and multi-row INSERT statements for the table name.
+  void BuildStmt(const std::string& name, const Datum::Vals& vals);
+
+  /// Writes rows grouped by table to the database as a single transaction.
+  void WriteTables(std::map<std::string, TableRows>& tables);
+
+  /// Binds rows of the table name to INSERT statements, as many rows per
+  /// statement as possible.
+  void WriteRows(const std::string& name, const TableRows& t);
+
+  /// Writes queued batches until the backend is destroyed.
+  void WriteLoop();
+
+  /// Stops and joins the writer thread.
+  void StopWriter();
+
+  /// Throws an IOError for a pending write error.  Requires mu_ to be held.
+  void ThrowWriteErr();
 
   /// An interface to a sqlite db managed by the SqliteBack class.
   SqliteDb db_;
@@ -82,6 +175,47 @@ class SqliteBack: public FullBackend {
 
   std::map<std::string, SqlStatement::Ptr> stmts_;
   std::map<std::string, std::vector<DbTypes> > schemas_;
+
+  /// multi-row INSERT statements and the number of rows each binds.
+  std::map<std::string, std::pair<SqlStatement::Ptr, int> > multi_stmts_;
+
+  /// field names and types of tables, by table name.
+  std::map<std::string, QueryResult> infos_;
+
+  /// prepared query statements by sql text, along with their position in
+  /// the least recently used list.
+  typedef std::pair<SqlStatement::Ptr, std::list<std::string>::iterator>
+      CachedStmt;
+  std::map<std::string, CachedStmt> query_stmts_;
+  std::list<std::string> query_lru_;
+
+  IndexPolicy index_policy_;
+
+  /// "table.field" names of key columns that have been indexed.
+  std::set<std::string> indexed_;
+
+  bool background_writes_;
+
+  /// guards the writer state below.
+  std::mutex mu_;
+
+  /// signals the writer that a batch was queued or that it should stop.
+  std::condition_variable queued_;
+
+  /// signals Notify and Flush that the writer finished a batch.
+  std::condition_variable written_;
+
+  std::deque<Batch> queue_;
+
+  /// true while the writer is writing a batch taken off the queue.
+  bool writing_;
+
+  bool stop_;
+
+  /// message of the first write error not yet reported by Flush.
+  std::string write_err_;
+
+  std::thread writer_;
 };
 
 }  // namespace cyclus
@@ -1,5 +1,8 @@
 #include "building_manager.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "prog_translator.h"
 #include "CoinPackedVector.hpp"
 
@@ -18,78 +21,221 @@ BuildOrder::BuildOrder(int n, Builder* b, CommodityProducer* cp)
 std::vector<BuildOrder> BuildingManager::MakeBuildDecision(Commodity& commodity,
                                                            double demand) {
   std::vector<BuildOrder> orders;
-  if (demand > 0) {
-    OsiCbcSolverInterface iface;
-    ProgTranslatorContext ctx;
-    std::map<CommodityProducer*, Builder*> p_to_b;
-    std::map<int, CommodityProducer*> idx_to_p;
-    SetUp_(iface, ctx, p_to_b, idx_to_p, commodity, demand);
-    Solve_(iface, ctx, p_to_b, idx_to_p, orders);
+  if (demand <= 0) {
+    return orders;
   }
+  std::vector<Column> cols = Columns_(commodity);
+  if (cols.empty()) {
+    return orders;
+  }
+
+  BuildModel& m = models_[commodity];
+  if (demand == m.demand && cols == m.last_cols) {
+    return m.orders;
+  }
+
+  Update_(m, cols);
+  Solve_(m, demand);
+
+  std::map<CommodityProducer*, int> idx;
+  for (int i = 0; i != m.cols.size(); i++) {
+    idx[m.cols[i].producer] = i;
+  }
+  for (int i = 0; i != cols.size(); i++) {
+    int n = static_cast<int>(m.solution[idx[cols[i].producer]]);
+    if (n > 0) {
+      orders.push_back(BuildOrder(n, cols[i].builder, cols[i].producer));
+    }
+  }
+
+  m.demand = demand;
+  m.last_cols = cols;
+  m.orders = orders;
   return orders;
 }
 
-void BuildingManager::SetUp_(OsiCbcSolverInterface& iface,
-                             ProgTranslatorContext& ctx,
-                             std::map<CommodityProducer*, Builder*>& p_to_b,
-                             std::map<int, CommodityProducer*>& idx_to_p,
-                             Commodity& commodity,
-                             double demand) {
-  CoinPackedVector caps;
+std::vector<BuildingManager::Column> BuildingManager::Columns_(
+    Commodity& commodity) {
+  std::vector<Column> cols;
   std::set<Builder*>::iterator bit;
   std::set<CommodityProducer*>::iterator pit;
-  CommodityProducer* p;
-  Builder* b;
-  int idx = 0;
-  double inf = iface.getInfinity();
   for (bit = builders_.begin(); bit != builders_.end(); ++bit) {
-    b = *bit;
+    Builder* b = *bit;
     for (pit = b->producers().begin(); pit != b->producers().end(); ++pit) {
-      p = *pit;
+      CommodityProducer* p = *pit;
       if (p->Produces(commodity)) {
-        ctx.obj_coeffs.push_back(p->Cost(commodity));
-        caps.insert(idx, p->Capacity(commodity));
-        ctx.col_lbs.push_back(0);
-        ctx.col_ubs.push_back(inf);
-        p_to_b[p] = b;
-        idx_to_p[idx] = p;
-        idx++;
+        Column c;
+        c.producer = p;
+        c.builder = b;
+        c.cost = p->Cost(commodity);
+        c.capacity = p->Capacity(commodity);
+        cols.push_back(c);
       }
     }
   }
-  ctx.row_ubs.push_back(inf);
-  ctx.row_lbs.push_back(demand);
-  ctx.m.setDimensions(0, ctx.col_ubs.size());
-  ctx.m.appendRow(caps);
+  return cols;
+}
+
+void BuildingManager::Update_(BuildModel& m, const std::vector<Column>& cols) {
+  if (m.iface.get() == NULL) {
+    m.iface.reset(new OsiCbcSolverInterface());
+    OsiCbcSolverInterface& iface = *m.iface;
+    ProgTranslatorContext ctx;
+    CoinPackedVector caps;
+    double inf = iface.getInfinity();
+    for (int i = 0; i != cols.size(); i++) {
+      ctx.obj_coeffs.push_back(cols[i].cost);
+      caps.insert(i, cols[i].capacity);
+      ctx.col_lbs.push_back(0);
+      ctx.col_ubs.push_back(inf);
+    }
+    ctx.row_ubs.push_back(inf);
+    ctx.row_lbs.push_back(0);
+    ctx.m.setDimensions(0, ctx.col_ubs.size());
+    ctx.m.appendRow(caps);
+
+    iface.setObjSense(1.0);  // minimize
+    iface.loadProblem(ctx.m, &ctx.col_lbs[0], &ctx.col_ubs[0],
+                      &ctx.obj_coeffs[0], &ctx.row_lbs[0], &ctx.row_ubs[0]);
+    for (int i = 0; i != cols.size(); i++) {
+      iface.setInteger(i);
+    }
+    m.cols = cols;
+    m.solution.assign(cols.size(), 0);
+    return;
+  }
+
+  OsiCbcSolverInterface& iface = *m.iface;
+  std::map<CommodityProducer*, const Column*> current;
+  for (int i = 0; i != cols.size(); i++) {
+    current[cols[i].producer] = &cols[i];
+  }
+
+  // drop the columns of producers that are gone or whose capacity changed;
+  // the latter are added back below
+  std::vector<int> gone;
+  std::vector<Column> kept;
+  std::vector<double> kept_sol;
+  for (int i = 0; i != m.cols.size(); i++) {
+    std::map<CommodityProducer*, const Column*>::iterator it =
+        current.find(m.cols[i].producer);
+    if (it == current.end() || it->second->capacity != m.cols[i].capacity) {
+      gone.push_back(i);
+    } else {
+      kept.push_back(*it->second);
+      kept_sol.push_back(m.solution[i]);
+      current.erase(it);
+    }
+  }
+  if (!gone.empty()) {
+    iface.deleteCols(gone.size(), &gone[0]);
+  }
+
+  // kept columns are renumbered by the deletion, so costs are updated after
+  // it
+  const double* obj = iface.getObjCoefficients();
+  for (int i = 0; i != kept.size(); i++) {
+    if (obj[i] != kept[i].cost) {
+      iface.setObjCoeff(i, kept[i].cost);
+    }
+  }
+
+  // add columns for new producers, keeping builder order among them
+  double inf = iface.getInfinity();
+  for (int i = 0; i != cols.size(); i++) {
+    if (current.count(cols[i].producer) == 0) {
+      continue;
+    }
+    CoinPackedVector cap;
+    cap.insert(0, cols[i].capacity);
+    iface.addCol(cap, 0, inf, cols[i].cost);
+    iface.setInteger(kept.size());
+    kept.push_back(cols[i]);
+    kept_sol.push_back(0);
+  }
+  m.cols = kept;
+  m.solution = kept_sol;
 }
 
-void BuildingManager::Solve_(OsiCbcSolverInterface& iface,
-                             ProgTranslatorContext& ctx,
-                             std::map<CommodityProducer*, Builder*>& p_to_b,
-                             std::map<int, CommodityProducer*>& idx_to_p,
-                             std::vector<BuildOrder>& orders) {
-  int nvar = ctx.col_ubs.size();
-  iface.setObjSense(1.0);  // minimize
-  iface.loadProblem(ctx.m, &ctx.col_lbs[0], &ctx.col_ubs[0],
-                    &ctx.obj_coeffs[0], &ctx.row_lbs[0], &ctx.row_ubs[0]);
-  for (int i = 0; i != nvar; i++) {
-    iface.setInteger(i);
-  }
-  iface.initialSolve();
+std::vector<double> BuildingManager::WarmStart_(const BuildModel& m,
+                                                double demand) {
+  std::vector<double> start = m.solution;
+  double cap = 0;
+  int best = -1;
+  for (int i = 0; i != m.cols.size(); i++) {
+    const Column& c = m.cols[i];
+    start[i] = std::floor(start[i]);
+    cap += start[i] * c.capacity;
+    if (c.capacity > 0 &&
+        (best < 0 ||
+         c.cost * m.cols[best].capacity < m.cols[best].cost * c.capacity)) {
+      best = i;
+    }
+  }
+  if (cap < demand) {
+    if (best < 0) {
+      return std::vector<double>();
+    }
+    start[best] += std::ceil((demand - cap) / m.cols[best].capacity);
+  }
+  return start;
+}
+
+void BuildingManager::Solve_(BuildModel& m, double demand) {
+  OsiCbcSolverInterface& iface = *m.iface;
+  bool solved = m.demand >= 0;
+  iface.setRowLower(0, demand);
+
+  // after the first decision, any solution worse than the warm start can be
+  // pruned
+  std::vector<double> start;
+  if (solved) {
+    start = WarmStart_(m, demand);
+  }
+  double cutoff = iface.getInfinity();
+  if (!start.empty()) {
+    cutoff = 0;
+    for (int i = 0; i != m.cols.size(); i++) {
+      cutoff += start[i] * m.cols[i].cost;
+    }
+    cutoff += 1e-6 * std::max(1.0, std::fabs(cutoff));
+  }
+  iface.getModelPtr()->setCutoff(cutoff);
+
+  if (solved) {
+    iface.resolve();  // warm started from the previous basis
+  } else {
+    iface.initialSolve();
+  }
   iface.branchAndBound();
 
+  // the model's bestSolution() is not guaranteed to be cleared between
+  // branch and bound calls, so the column solution itself is checked; if
+  // nothing was found within the cutoff it holds a relaxed or stale point
   const double* sol = iface.getColSolution();
-  int n;
-  CommodityProducer* p;
-  Builder* b;
-  for (int i = 0; i != nvar; i++) {
-    n = static_cast<int>(sol[i]);
-    if (n > 0) {
-      p = idx_to_p[i];
-      b = p_to_b[p];
-      orders.push_back(BuildOrder(n, b, p));
+  if (!start.empty() && !Satisfies_(m, sol, demand, cutoff)) {
+    sol = &start[0];  // nothing better than the warm start was found
+  }
+  m.solution.assign(sol, sol + m.cols.size());
+}
+
+bool BuildingManager::Satisfies_(const BuildModel& m, const double* sol,
+                                 double demand, double cutoff) {
+  if (sol == NULL) {
+    return false;
+  }
+  double cap = 0;
+  double cost = 0;
+  for (int i = 0; i != m.cols.size(); i++) {
+    double n = std::floor(sol[i] + 0.5);
+    if (n < 0 || std::fabs(sol[i] - n) > 1e-6) {
+      return false;
     }
+    cap += n * m.cols[i].capacity;
+    cost += n * m.cols[i].cost;
   }
+  double eps = 1e-6 * std::max(1.0, std::fabs(demand));
+  return cap >= demand - eps && cost <= cutoff;
 }
 
 }  // namespace toolkit
@@ -4,6 +4,8 @@
 #include <map>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include "agent_managed.h"
 #include "builder.h"
 #include "commodity_producer.h"
@@ -11,9 +13,6 @@
 class OsiCbcSolverInterface;
 
 namespace cyclus {
-
-class ProgTranslatorContext;
-
 namespace toolkit {
 
 /// A struct for a build order: the number of producers to build.
@@ -43,6 +42,14 @@ struct BuildOrder {
 /// cost to build the object of type i, \f$\phi_i\f$ is the nameplate
 /// capacity of the object, and \f$\Phi\f$ is the capacity demand. Here
 /// the set I corresponds to all producers of a given commodity.
+///
+/// The program for each commodity is kept between decisions.  When the same
+/// decision is requested again (same demand, builders, producers, costs and
+/// capacities) the previous orders are returned without solving.  Otherwise
+/// only the demand and the columns of producers that changed are updated,
+/// the LP relaxation is resolved from the previous basis, and the previous
+/// build decision, topped up with the most capacity-efficient producer if it
+/// no longer meets demand, bounds the branch and bound search.
 class BuildingManager : public AgentManaged {
  public:
   BuildingManager(Agent* agent = NULL) : AgentManaged(agent) {}
@@ -70,20 +77,58 @@ class BuildingManager : public AgentManaged {
   }
 
  private:
-  std::set<Builder*> builders_;
+  /// A producer that can be built, i.e. a column of the program.
+  struct Column {
+    CommodityProducer* producer;
+    Builder* builder;
+    double cost;
+    double capacity;
+
+    bool operator==(const Column& other) const {
+      return producer == other.producer && builder == other.builder &&
+             cost == other.cost && capacity == other.capacity;
+    }
+  };
+
+  /// The program for one commodity, kept between decisions.
+  struct BuildModel {
+    BuildModel() : demand(-1) {}
+
+    /// the columns in the order of the solver's columns
+    std::vector<Column> cols;
+
+    /// the last decision's demand, columns (in builder order) and orders,
+    /// which are returned again while they don't change
+    double demand;
+    std::vector<Column> last_cols;
+    std::vector<BuildOrder> orders;
 
-  void SetUp_(OsiCbcSolverInterface& iface,
-              ProgTranslatorContext& ctx,
-              std::map<CommodityProducer*, Builder*>& p_to_b,
-              std::map<int, CommodityProducer*>& idx_to_p,
-              Commodity& commodity,
-              double demand);
-
-  void Solve_(OsiCbcSolverInterface& iface,
-              ProgTranslatorContext& ctx,
-              std::map<CommodityProducer*, Builder*>& p_to_b,
-              std::map<int, CommodityProducer*>& idx_to_p,
-              std::vector<BuildOrder>& orders);
+    /// the last integer solution, in the order of cols
+    std::vector<double> solution;
+
+    boost::shared_ptr<OsiCbcSolverInterface> iface;
+  };
+
+  /// Returns the columns for commodity in builder order.
+  std::vector<Column> Columns_(Commodity& commodity);
+
+  /// Builds the solver of m, or updates its columns to cols.
+  void Update_(BuildModel& m, const std::vector<Column>& cols);
+
+  /// Returns an integer solution meeting demand derived from the previous
+  /// one, or an empty vector if there is none.
+  std::vector<double> WarmStart_(const BuildModel& m, double demand);
+
+  /// Solves the updated program of m, storing its solution.
+  void Solve_(BuildModel& m, double demand);
+
+  /// Returns true if sol is an integer solution of m meeting demand at a
+  /// cost of at most cutoff.
+  bool Satisfies_(const BuildModel& m, const double* sol, double demand,
+                  double cutoff);
+
+  std::set<Builder*> builders_;
+  std::map<Commodity, BuildModel, CommodityCompare> models_;
 };
 
 }  // namespace toolkit
@@ -1,5 +1,7 @@
 #include "commodity_producer.h"
 
+#include "commodity_producer_manager.h"
+
 namespace cyclus {
 namespace toolkit {
 
@@ -14,7 +16,90 @@ CommodityProducer::CommodityProducer(double default_capacity,
       default_capacity_(default_capacity),
       default_cost_(default_cost) {}
 
-CommodityProducer::~CommodityProducer() {}
+CommodityProducer::CommodityProducer(const CommodityProducer& other)
+    : AgentManaged(other),
+      commodities_(other.commodities_),
+      default_capacity_(other.default_capacity_),
+      default_cost_(other.default_cost_) {}
+
+CommodityProducer& CommodityProducer::operator=(
+    const CommodityProducer& other) {
+  if (this == &other) {
+    return *this;
+  }
+  AgentManaged::operator=(other);
+  // withdraw the old capacities from the managers before taking the new ones
+  std::map<Commodity, CommodInfo, CommodityCompare>::iterator it;
+  for (it = commodities_.begin(); it != commodities_.end(); ++it) {
+    Notify(it->first, -it->second.capacity, -1);
+  }
+  commodities_ = other.commodities_;
+  for (it = commodities_.begin(); it != commodities_.end(); ++it) {
+    Notify(it->first, it->second.capacity, 1);
+  }
+  default_capacity_ = other.default_capacity_;
+  default_cost_ = other.default_cost_;
+  return *this;
+}
+
+CommodityProducer::~CommodityProducer() {
+  // copy, since unregistering modifies managers_
+  std::set<CommodityProducerManager*> managers = managers_;
+  std::set<CommodityProducerManager*>::iterator it;
+  for (it = managers.begin(); it != managers.end(); ++it) {
+    (*it)->Unregister(this);
+  }
+}
+
+void CommodityProducer::SetCapacity(const Commodity& commodity,
+                                    double capacity) {
+  std::map<Commodity, CommodInfo, CommodityCompare>::iterator it =
+      commodities_.find(commodity);
+  if (it == commodities_.end()) {
+    CommodInfo info;
+    info.capacity = capacity;
+    Add(commodity, info);
+  } else {
+    Notify(commodity, capacity - it->second.capacity, 0);
+    it->second.capacity = capacity;
+  }
+}
+
+void CommodityProducer::SetCost(const Commodity& commodity, double cost) {
+  std::map<Commodity, CommodInfo, CommodityCompare>::iterator it =
+      commodities_.find(commodity);
+  if (it == commodities_.end()) {
+    CommodInfo info;
+    info.cost = cost;
+    Add(commodity, info);
+  } else {
+    it->second.cost = cost;
+  }
+}
+
+void CommodityProducer::Add(const Commodity& commodity,
+                            const CommodInfo& info) {
+  if (commodities_.insert(std::make_pair(commodity, info)).second) {
+    Notify(commodity, info.capacity, 1);
+  }
+}
+
+void CommodityProducer::Rm(const Commodity& commodity) {
+  std::map<Commodity, CommodInfo, CommodityCompare>::iterator it =
+      commodities_.find(commodity);
+  if (it != commodities_.end()) {
+    Notify(commodity, -it->second.capacity, -1);
+    commodities_.erase(it);
+  }
+}
+
+void CommodityProducer::Notify(const Commodity& commodity, double dcap,
+                               int dcount) {
+  std::set<CommodityProducerManager*>::iterator it;
+  for (it = managers_.begin(); it != managers_.end(); ++it) {
+    (*it)->Changed(commodity, dcap, dcount);
+  }
+}
 
 std::set<Commodity, CommodityCompare> CommodityProducer::ProducedCommodities() {
   std::set<Commodity, CommodityCompare> commodities;
@@ -11,6 +11,8 @@
 namespace cyclus {
 namespace toolkit {
 
+class CommodityProducerManager;
+
 /// A container to hold information about a commodity
 struct CommodInfo {
   CommodInfo(double default_capacity = 0,
@@ -20,11 +22,25 @@ struct CommodInfo {
 };
 
 /// A mixin to provide information about produced commodities
+///
+/// Producers tell the CommodityProducerManagers they are registered with
+/// about every change of their production capacities, so that managers can
+/// keep running totals.
 class CommodityProducer : public AgentManaged {
+  friend class CommodityProducerManager;
+
  public:
   CommodityProducer(double default_capacity = 0,
                     double default_cost = kModifierLimit,
                     Agent* agent = NULL);
+
+  /// Copies the produced commodities of other, but not its registrations
+  /// with managers.
+  CommodityProducer(const CommodityProducer& other);
+
+  CommodityProducer& operator=(const CommodityProducer& other);
+
+  /// Unregisters the producer from its managers.
   virtual ~CommodityProducer();
 
   /// @param commodity the commodity in question
@@ -34,30 +50,34 @@ class CommodityProducer : public AgentManaged {
   }
 
   /// @param commodity the commodity in question
-  /// @return the production capacity for a commodity
-  inline double Capacity(const Commodity& commodity) {
-    return commodities_[commodity].capacity;
+  /// @return the production capacity for a commodity, or zero if it isn't
+  /// produced
+  inline double Capacity(const Commodity& commodity) const {
+    std::map<Commodity, CommodInfo, CommodityCompare>::const_iterator it =
+        commodities_.find(commodity);
+    return it == commodities_.end() ? CommodInfo().capacity
+                                    : it->second.capacity;
   }
 
   /// @return the cost to produce a commodity at a given capacity
   /// @param commodity the commodity in question
-  inline double Cost(const Commodity& commodity) {
-    return commodities_[commodity].cost;
+  inline double Cost(const Commodity& commodity) const {
+    std::map<Commodity, CommodInfo, CommodityCompare>::const_iterator it =
+        commodities_.find(commodity);
+    return it == commodities_.end() ? CommodInfo().cost : it->second.cost;
   }
 
-  /// Set the production capacity for a given commodity
+  /// Set the production capacity for a given commodity, registering it as
+  /// produced if it isn't yet
   /// @param commodity the commodity being produced
   /// @param capacity the production capacity
-  inline void SetCapacity(const Commodity& commodity, double capacity) {
-    commodities_[commodity].capacity = capacity;
-  }
+  void SetCapacity(const Commodity& commodity, double capacity);
 
-  /// Set the production cost for a given commodity
+  /// Set the production cost for a given commodity, registering it as
+  /// produced if it isn't yet
   /// @param commodity the commodity being produced
   /// @param cost the production cost
-  inline void SetCost(const Commodity& commodity, double cost) {
-    commodities_[commodity].cost = cost;
-  }
+  void SetCost(const Commodity& commodity, double cost);
 
   /// Register a commodity as being produced by this object
   /// @param commodity the commodity being produced
@@ -69,15 +89,11 @@ class CommodityProducer : public AgentManaged {
   /// its relevant info
   /// @param commodity the commodity being produced
   /// @param info the information describing the commodity
-  inline void Add(const Commodity& commodity, const CommodInfo& info) {
-    commodities_.insert(std::make_pair(commodity, info));
-  }
+  void Add(const Commodity& commodity, const CommodInfo& info);
 
   /// Unregister a commodity as being produced by this object
   /// @param commodity the commodity being produced
-  inline void Rm(const Commodity& commodity) {
-    commodities_.erase(commodity);
-  }
+  void Rm(const Commodity& commodity);
 
   /// @return the set of commodities produced by this producers
   std::set<Commodity, CommodityCompare> ProducedCommodities();
@@ -95,6 +111,13 @@ class CommodityProducer : public AgentManaged {
 
   /// A default production cost
   double default_cost_;
+
+  /// Tells the managers of this producer that its capacity for commodity
+  /// changed by dcap and the number of producers of it by dcount.
+  void Notify(const Commodity& commodity, double dcap, int dcount);
+
+  /// The managers this producer is registered with
+  std::set<CommodityProducerManager*> managers_;
 };
 
 }  // namespace toolkit
@@ -1,19 +1,98 @@
 #include "commodity_producer_manager.h"
 
+#include "supply_demand_manager.h"
+
 namespace cyclus {
 namespace toolkit {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double CommodityProducerManager::TotalCapacity(Commodity& commodity) {
-  double total = 0.0;
+CommodityProducerManager::CommodityProducerManager(
+    const CommodityProducerManager& other)
+    : AgentManaged(other) {
+  std::set<CommodityProducer*>::const_iterator it;
+  for (it = other.producers_.begin(); it != other.producers_.end(); ++it) {
+    Register(*it);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CommodityProducerManager& CommodityProducerManager::operator=(
+    const CommodityProducerManager& other) {
+  if (this == &other) {
+    return *this;
+  }
+  AgentManaged::operator=(other);
+  std::set<CommodityProducer*> old = producers_;
+  std::set<CommodityProducer*>::const_iterator it;
+  for (it = old.begin(); it != old.end(); ++it) {
+    Unregister(*it);
+  }
+  for (it = other.producers_.begin(); it != other.producers_.end(); ++it) {
+    Register(*it);
+  }
+  return *this;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CommodityProducerManager::~CommodityProducerManager() {
+  std::set<SupplyDemandManager*> sdms = sd_managers_;
+  std::set<SupplyDemandManager*>::iterator sit;
+  for (sit = sdms.begin(); sit != sdms.end(); ++sit) {
+    (*sit)->UnregisterProducerManager(this);
+  }
   std::set<CommodityProducer*>::iterator it;
-  CommodityProducer* p;
   for (it = producers_.begin(); it != producers_.end(); ++it) {
-    p = *it;
-    if (p->Produces(commodity))
-      total += p->Capacity(commodity);
+    (*it)->managers_.erase(this);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double CommodityProducerManager::TotalCapacity(Commodity& commodity) {
+  std::map<Commodity, SupplyTotal, CommodityCompare>::iterator it =
+      totals_.find(commodity);
+  return it == totals_.end() ? 0.0 : it->second.capacity.value();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CommodityProducerManager::Register(CommodityProducer* producer) {
+  if (!producers_.insert(producer).second) {
+    return;
+  }
+  producer->managers_.insert(this);
+  std::map<Commodity, CommodInfo, CommodityCompare>::iterator it;
+  for (it = producer->commodities_.begin();
+       it != producer->commodities_.end(); ++it) {
+    Changed(it->first, it->second.capacity, 1);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CommodityProducerManager::Unregister(CommodityProducer* producer) {
+  if (producers_.erase(producer) == 0) {
+    return;
+  }
+  producer->managers_.erase(this);
+  std::map<Commodity, CommodInfo, CommodityCompare>::iterator it;
+  for (it = producer->commodities_.begin();
+       it != producer->commodities_.end(); ++it) {
+    Changed(it->first, -it->second.capacity, -1);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CommodityProducerManager::Changed(const Commodity& commodity,
+                                       double dcap, int dcount) {
+  SupplyTotal& t = totals_[commodity];
+  t.capacity.Add(dcap);
+  t.nproducers += dcount;
+  if (t.nproducers == 0) {
+    totals_.erase(commodity);
+  }
+
+  std::set<SupplyDemandManager*>::iterator it;
+  for (it = sd_managers_.begin(); it != sd_managers_.end(); ++it) {
+    (*it)->Changed(commodity, dcap, dcount);
   }
-  return total;
 }
 
 }  // namespace toolkit
@@ -1,20 +1,50 @@
 #ifndef CYCLUS_SRC_TOOLKIT_COMMODITY_PRODUCER_MANAGER_H_
 #define CYCLUS_SRC_TOOLKIT_COMMODITY_PRODUCER_MANAGER_H_
 
+#include <map>
 #include <set>
 
 #include "agent_managed.h"
 #include "commodity.h"
 #include "commodity_producer.h"
+#include "cyc_arithmetic.h"
 
 namespace cyclus {
 namespace toolkit {
 
+class SupplyDemandManager;
+
+/// A running total of the production capacity of a commodity.
+struct SupplyTotal {
+  SupplyTotal() : nproducers(0) {}
+
+  CompensatedSum capacity;
+
+  /// the number of producers contributing, so that the total drops to
+  /// exactly zero once the last one is gone
+  int nproducers;
+};
+
 /// A mixin to provide information about commodity producers
+///
+/// The manager keeps a running capacity total for each commodity, updated
+/// whenever a producer is registered or unregistered or changes its
+/// capacities, so TotalCapacity doesn't visit the producers.  Producers
+/// unregister themselves when they are destroyed.
 class CommodityProducerManager : public AgentManaged {
+  friend class CommodityProducer;
+  friend class SupplyDemandManager;
+
  public:
   CommodityProducerManager(Agent* agent = NULL) : AgentManaged(agent) {}
-  virtual ~CommodityProducerManager() {}
+
+  /// Registers the producers of other with the new manager.
+  CommodityProducerManager(const CommodityProducerManager& other);
+
+  CommodityProducerManager& operator=(const CommodityProducerManager& other);
+
+  /// Unregisters all producers and detaches from supply demand managers.
+  virtual ~CommodityProducerManager();
 
   /// @return the total production capacity for a commodity amongst producers
   /// @param commodity the commodity in question
@@ -22,23 +52,28 @@ class CommodityProducerManager : public AgentManaged {
 
   /// Register a commodity producer with the manager
   /// @param producer the producer
-  inline void Register(CommodityProducer* producer) {
-    producers_.insert(producer);
-  }
+  void Register(CommodityProducer* producer);
 
   /// Unregister a commodity producer with the manager
   /// @param producer the producer
-  inline void Unregister(CommodityProducer* producer) {
-    producers_.erase(producer);
-  }
+  void Unregister(CommodityProducer* producer);
 
   inline const std::set<CommodityProducer*>& producers() const {
     return producers_;
   }
 
  private:
+  /// Applies a change of dcap capacity and dcount producers of commodity.
+  void Changed(const Commodity& commodity, double dcap, int dcount);
+
   /// The set of managed producers
   std::set<CommodityProducer*> producers_;
+
+  /// The running totals of the producers
+  std::map<Commodity, SupplyTotal, CommodityCompare> totals_;
+
+  /// The supply demand managers this manager is registered with
+  std::set<SupplyDemandManager*> sd_managers_;
 };
 
 }  // namespace toolkit
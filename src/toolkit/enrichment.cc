@@ -6,7 +6,6 @@
 #include "error.h"
 #include "cyc_limits.h"
 #include "logger.h"
-#include "mat_query.h"
 
 namespace cyclus {
 namespace toolkit {
@@ -39,46 +38,21 @@ double UraniumAssay(Material::Ptr rsrc) {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double UraniumAssayAtom(Material::Ptr rsrc) {
-  double value;
-  MatQuery mq(rsrc);
-  double u235 = mq.atom_frac(922350000);
-  double u238 = mq.atom_frac(922380000);
-
-  LOG(LEV_DEBUG1, "CEnr") << "Comparing u235 atom fraction : "
-                          << u235 << " with u238 atom fraction: "
-                          << u238;
-
-  if (u235 + u238 > 0) {
-    value = u235 / (u235 + u238);
-  } else {
-    value = 0;
-  }
+  double value = rsrc->comp()->uranium_assay_atom();
+  LOG(LEV_DEBUG1, "CEnr") << "U-235 atom fraction of uranium: " << value;
   return value;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double UraniumAssayMass(Material::Ptr rsrc) {
-  double value;
-  MatQuery mq(rsrc);
-  double u235 = mq.mass_frac(922350000);
-  double u238 = mq.mass_frac(922380000);
-
-  LOG(LEV_DEBUG1, "CEnr") << "Comparing u235 mass fraction : "
-                          << u235 << " with u238 mass fraction: "
-                          << u238;
-
-  if (u235 + u238 > 0) {
-    value = u235 / (u235 + u238);
-  } else {
-    value = 0;
-  }
+  double value = rsrc->comp()->uranium_assay_mass();
+  LOG(LEV_DEBUG1, "CEnr") << "U-235 mass fraction of uranium: " << value;
   return value;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double UraniumQty(Material::Ptr rsrc) {
-  MatQuery mq(rsrc);
-  return mq.mass(922350000) + mq.mass(922380000);
+  return rsrc->quantity() * rsrc->comp()->uranium_mass_frac();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -100,7 +74,8 @@ double TailsQty(double product_qty, const Assays& assays) {
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double ValueFunc(double frac) {
+/// Throws if frac is outside of the domain of the value function, [0,1).
+static void CheckFrac(double frac) {
   if (frac < 0) {
     std::stringstream msg;
     msg << "The provided fraction (" << frac
@@ -114,10 +89,123 @@ double ValueFunc(double frac) {
         << ") is higher than the acceptable range.";
     throw ValueError(msg.str());
   }
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ValueFunc(double frac) {
+  CheckFrac(frac);
   return (1 - 2 * frac) * std::log(1 / frac - 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// Throws if any of the feed, product or tails assays is outside of [0,1).
+static void CheckAssays(const Assays& assays) {
+  CheckFrac(assays.Feed());
+  CheckFrac(assays.Product());
+  CheckFrac(assays.Tails());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// Validates the inputs of a batch calculation: there must be one assay per
+/// product quantity and every assay must be in [0,1).
+static void CheckBatch(const std::vector<double>& product_qty,
+                       const std::vector<Assays>& assays) {
+  if (product_qty.size() != assays.size()) {
+    std::stringstream msg;
+    msg << "Got " << product_qty.size() << " product quantities but "
+        << assays.size() << " assays.";
+    throw ValueError(msg.str());
+  }
+  for (int i = 0; i < assays.size(); ++i) {
+    CheckAssays(assays[i]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// Splits assays into contiguous feed, product and tails arrays.
+static void SplitAssays(const std::vector<Assays>& assays,
+                        std::vector<double>* feed,
+                        std::vector<double>* product,
+                        std::vector<double>* tails) {
+  int n = assays.size();
+  feed->resize(n);
+  product->resize(n);
+  tails->resize(n);
+  for (int i = 0; i < n; ++i) {
+    (*feed)[i] = assays[i].Feed();
+    (*product)[i] = assays[i].Product();
+    (*tails)[i] = assays[i].Tails();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> ValueFunc(const std::vector<double>& fracs) {
+  int n = fracs.size();
+  for (int i = 0; i < n; ++i) {
+    CheckFrac(fracs[i]);
+  }
+
+  std::vector<double> v(n);
+  const double* f = fracs.data();
+  double* out = v.data();
+  for (int i = 0; i < n; ++i) {
+    out[i] = (1 - 2 * f[i]) * std::log(1 / f[i] - 1);
+  }
+  return v;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// Returns product_qty scaled by factor.
+static std::vector<double> Scaled(const std::vector<double>& product_qty,
+                                  double factor) {
+  std::vector<double> v(product_qty);
+  for (int i = 0; i < v.size(); ++i) {
+    v[i] *= factor;
+  }
+  return v;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> FeedQty(const std::vector<double>& product_qty,
+                            const Assays& assays) {
+  CheckAssays(assays);
+  return Scaled(product_qty, FeedQty(1, assays));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> FeedQty(const std::vector<double>& product_qty,
+                            const std::vector<Assays>& assays) {
+  CheckBatch(product_qty, assays);
+  std::vector<double> f, p, t;
+  SplitAssays(assays, &f, &p, &t);
+  std::vector<double> v(product_qty);
+  for (int i = 0; i < v.size(); ++i) {
+    v[i] *= (p[i] - t[i]) / (f[i] - t[i]);
+  }
+  return v;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> TailsQty(const std::vector<double>& product_qty,
+                             const Assays& assays) {
+  CheckAssays(assays);
+  return Scaled(product_qty, TailsQty(1, assays));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> TailsQty(const std::vector<double>& product_qty,
+                             const std::vector<Assays>& assays) {
+  CheckBatch(product_qty, assays);
+  std::vector<double> f, p, t;
+  SplitAssays(assays, &f, &p, &t);
+  std::vector<double> v(product_qty);
+  for (int i = 0; i < v.size(); ++i) {
+    v[i] *= (p[i] - f[i]) / (f[i] - t[i]);
+  }
+  return v;
+}
+
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double SwuRequired(double product_qty, const Assays& assays) {
   double feed = FeedQty(product_qty, assays);
@@ -129,5 +217,31 @@ double SwuRequired(double product_qty, const Assays& assays) {
   return swu;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> SwuRequired(const std::vector<double>& product_qty,
+                                const Assays& assays) {
+  CheckAssays(assays);
+  return Scaled(product_qty, SwuRequired(1, assays));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> SwuRequired(const std::vector<double>& product_qty,
+                                const std::vector<Assays>& assays) {
+  CheckBatch(product_qty, assays);
+  std::vector<double> f, p, t;
+  SplitAssays(assays, &f, &p, &t);
+  std::vector<double> vf = ValueFunc(f);
+  std::vector<double> vp = ValueFunc(p);
+  std::vector<double> vt = ValueFunc(t);
+
+  std::vector<double> swu(product_qty);
+  for (int i = 0; i < swu.size(); ++i) {
+    double feed = (p[i] - t[i]) / (f[i] - t[i]);
+    double tails = (p[i] - f[i]) / (f[i] - t[i]);
+    swu[i] *= vp[i] + tails * vt[i] - feed * vf[i];
+  }
+  return swu;
+}
+
 }  // namespace toolkit
 }  // namespace cyclus
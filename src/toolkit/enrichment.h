@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_TOOLKIT_ENRICHMENT_H_
 
 #include <set>
+#include <vector>
 
 #include "material.h"
 
@@ -77,6 +78,32 @@ double SwuRequired(double product_qty, const Assays& assays);
 /// @return the value function for a given fraction in [0,1)
 double ValueFunc(double frac);
 
+/// Batch versions of the functions above for enrichment facilities that
+/// evaluate many candidate trades per time step.  Every feed, product and
+/// tails assay (and every fraction passed to ValueFunc) is checked to be in
+/// [0,1) before anything is computed, and the arithmetic runs in branch free
+/// loops over contiguous arrays.  When every candidate shares the same assays,
+/// prefer the overloads taking a single Assays: feed, tails and swu are
+/// linear in the product quantity, so the value function (and its
+/// logarithms) is only evaluated once for the whole batch.
+/// @throws ValueError if the product quantities and assays differ in length
+/// or an assay or fraction is outside of [0,1)
+/// @{
+std::vector<double> ValueFunc(const std::vector<double>& fracs);
+std::vector<double> FeedQty(const std::vector<double>& product_qty,
+                            const Assays& assays);
+std::vector<double> FeedQty(const std::vector<double>& product_qty,
+                            const std::vector<Assays>& assays);
+std::vector<double> TailsQty(const std::vector<double>& product_qty,
+                             const Assays& assays);
+std::vector<double> TailsQty(const std::vector<double>& product_qty,
+                             const std::vector<Assays>& assays);
+std::vector<double> SwuRequired(const std::vector<double>& product_qty,
+                                const Assays& assays);
+std::vector<double> SwuRequired(const std::vector<double>& product_qty,
+                                const std::vector<Assays>& assays);
+/// @}
+
 }  // namespace toolkit
 }  // namespace cyclus
 
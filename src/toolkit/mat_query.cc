@@ -1,11 +1,136 @@
 #include "mat_query.h"
+#include "nuc_data.h"
 #include "pyne.h"
 
+#include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/weak_ptr.hpp>
 
 namespace cyclus {
 namespace toolkit {
 
+/// The aggregates of one composition shared by all queries.  Everything
+/// except the normalized mass quantities is computed on first use.
+struct CompSums {
+  /// detects entries of released compositions so they can be dropped, and
+  /// so that a new composition at a released one's address isn't matched
+  boost::weak_ptr<Composition> comp;
+  CompVec mass;
+  CompVec atom;
+  std::map<int, double> elem_mass;
+  std::map<int, double> elem_atom;
+  std::map<int, double> group_mass;
+  std::map<int, double> group_atom;
+};
+
+typedef std::unordered_map<const Composition*, CompSums> CompSumsTable;
+
+/// Guards the aggregates table and name cache.  Queries only hold it for a
+/// few lookups once a composition's aggregates exist.
+static std::mutex sums_mu;
+
+/// Aggregates by composition address, since compositions restored from a
+/// database can share ids.  Never destroyed, like other process wide
+/// caches, so queries during static destruction stay valid.
+static CompSumsTable& sums_table() {
+  static CompSumsTable* t = new CompSumsTable();
+  return *t;
+}
+
+/// The table size after the last sweep of released compositions.
+static std::size_t swept_size = 0;
+
+/// Returns the aggregates of c, creating them if needed.  The reference stays
+/// valid while c is alive.  sums_mu must be held.
+static CompSums& Sums(Composition::Ptr c) {
+  CompSumsTable& t = sums_table();
+  CompSumsTable::iterator it = t.find(c.get());
+  if (it != t.end() && !it->second.comp.expired()) {
+    return it->second;
+  }
+
+  // drop released compositions whenever the table has doubled, so sweeping
+  // is amortized over the insertions
+  if (t.size() >= 2 * std::max<std::size_t>(swept_size, 64)) {
+    for (it = t.begin(); it != t.end();) {
+      if (it->second.comp.expired()) {
+        it = t.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    swept_size = t.size();
+  }
+
+  CompSums& s = t[c.get()];
+  s = CompSums();
+  s.comp = c;
+  s.mass = c->mass_vec();
+  compmath::Normalize(&s.mass);
+  return s;
+}
+
+static const CompVec& AtomVec(Composition::Ptr c, CompSums* s) {
+  if (s->atom.empty() && !s->mass.empty()) {
+    s->atom = CompVec(c->atom());
+    compmath::Normalize(&s->atom);
+  }
+  return s->atom;
+}
+
+/// Returns the element totals of v, computing them into elems if needed.
+static const std::map<int, double>& ElemSums(const CompVec& v,
+                                             std::map<int, double>* elems) {
+  if (elems->empty()) {
+    const std::vector<Nuc>& nucs = v.nucs();
+    const std::vector<double>& vals = v.vals();
+    for (int i = 0; i < nucs.size(); ++i) {
+      (*elems)[nucs[i] / 10000000] += vals[i];
+    }
+  }
+  return *elems;
+}
+
+/// Returns the sum of the members of g in v, remembering it in groups.
+static double GroupSum(const CompVec& v, const NucGroup& g,
+                       std::map<int, double>* groups) {
+  std::map<int, double>::iterator it = groups->find(g.id());
+  if (it != groups->end()) {
+    return it->second;
+  }
+
+  double sum = 0;
+  const std::vector<Nuc>& nucs = v.nucs();
+  const std::vector<double>& vals = v.vals();
+  for (int i = 0; i < nucs.size(); ++i) {
+    if (g.Contains(nucs[i])) {
+      sum += vals[i];
+    }
+  }
+  (*groups)[g.id()] = sum;
+  return sum;
+}
+
+/// Returns the id of nuclide name nuc, parsing each name only once.
+static Nuc NucId(const std::string& nuc) {
+  static std::unordered_map<std::string, Nuc>* ids =
+      new std::unordered_map<std::string, Nuc>();
+  {
+    std::lock_guard<std::mutex> lock(sums_mu);
+    std::unordered_map<std::string, Nuc>::iterator it = ids->find(nuc);
+    if (it != ids->end()) {
+      return it->second;
+    }
+  }
+  Nuc id = pyne::nucname::id(nuc);
+  std::lock_guard<std::mutex> lock(sums_mu);
+  (*ids)[nuc] = id;
+  return id;
+}
+
 MatQuery::MatQuery(Material::Ptr m) : m_(m) {}
 
 double MatQuery::qty() {
@@ -17,13 +142,13 @@ double MatQuery::mass(Nuc nuc) {
 }
 
 double MatQuery::moles(Nuc nuc) {
-  return mass(nuc) / (pyne::atomic_mass(nuc) * units::g);
+  return mass(nuc) / (NucData::atomic_mass(nuc) * units::g);
 }
 
 double MatQuery::mass_frac(Nuc nuc) {
-  CompMap v = m_->comp()->mass();
-  compmath::Normalize(&v);
-  return v[nuc];
+  Composition::Ptr c = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  return Sums(c).mass.Get(nuc);
 }
 
 double MatQuery::mass_frac(std::set<Nuc> nucs) {
@@ -36,79 +161,110 @@ double MatQuery::mass_frac(std::set<Nuc> nucs) {
 }
 
 double MatQuery::atom_frac(Nuc nuc) {
-  CompMap v = m_->comp()->atom();
-  compmath::Normalize(&v);
-  return v[nuc];
+  Composition::Ptr c = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  return AtomVec(c, &Sums(c)).Get(nuc);
 }
 
 double MatQuery::atom_frac(std::set<Nuc> nucs) {
-  CompMap v = m_->comp()->atom();
-  compmath::Normalize(&v);
-  
+  Composition::Ptr c = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  const CompVec& v = AtomVec(c, &Sums(c));
+
   double frac_tot = 0;
   std::set<Nuc>::iterator it ;
   for (it = nucs.begin(); it != nucs.end(); ++it) {
-    if (v.find(*it) != v.end()){
-      frac_tot += v[*it];
-    }
+    frac_tot += v.Get(*it);
   }
   return frac_tot; 
 }
 
+double MatQuery::mass(const NucGroup& g) {
+  return mass_frac(g) * qty();
+}
+
+double MatQuery::mass_frac(const NucGroup& g) {
+  Composition::Ptr c = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  CompSums& s = Sums(c);
+  return GroupSum(s.mass, g, &s.group_mass);
+}
+
+double MatQuery::atom_frac(const NucGroup& g) {
+  Composition::Ptr c = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  CompSums& s = Sums(c);
+  return GroupSum(AtomVec(c, &s), g, &s.group_atom);
+}
+
+double MatQuery::elem_mass_frac(int z) {
+  Composition::Ptr c = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  CompSums& s = Sums(c);
+  const std::map<int, double>& elems = ElemSums(s.mass, &s.elem_mass);
+  std::map<int, double>::const_iterator it = elems.find(z);
+  return it == elems.end() ? 0 : it->second;
+}
+
+double MatQuery::elem_atom_frac(int z) {
+  Composition::Ptr c = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  CompSums& s = Sums(c);
+  const std::map<int, double>& elems = ElemSums(AtomVec(c, &s), &s.elem_atom);
+  std::map<int, double>::const_iterator it = elems.find(z);
+  return it == elems.end() ? 0 : it->second;
+}
+
 double MatQuery::mass(std::string nuc) {
-  return mass(pyne::nucname::id(nuc));
+  return mass(NucId(nuc));
 }
 
 double MatQuery::moles(std::string nuc) {
-  return moles(pyne::nucname::id(nuc));
+  return moles(NucId(nuc));
 }
 
 double MatQuery::mass_frac(std::string nuc) {
-  return mass_frac(pyne::nucname::id(nuc));
+  return mass_frac(NucId(nuc));
 }
 
 double MatQuery::atom_frac(std::string nuc) {
-  return atom_frac(pyne::nucname::id(nuc));
+  return atom_frac(NucId(nuc));
 }
 
 bool MatQuery::AlmostEq(Material::Ptr other, double threshold) {
-  CompMap n1 = m_->comp()->mass();
-  CompMap n2 = other->comp()->mass();
-  compmath::Normalize(&n1);
-  compmath::Normalize(&n2);
-  return compmath::AlmostEq(n1, n2, threshold);
+  Composition::Ptr c1 = m_->comp();
+  Composition::Ptr c2 = other->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  const CompVec& m1 = Sums(c1).mass;
+  return compmath::AlmostEq(m1, Sums(c2).mass, threshold);
 }
 
 double MatQuery::Amount(Composition::Ptr c) {
-  CompMap m = m_->comp()->mass();
-  CompMap m_other = c->mass();
-
-  compmath::Normalize(&m);
-  compmath::Normalize(&m_other);
+  Composition::Ptr mine = m_->comp();
+  std::lock_guard<std::mutex> lock(sums_mu);
+  const CompVec& m = Sums(mine).mass;
+  const CompVec& m_other = Sums(c).mass;
 
-  Nuc limiter;
   double min_ratio = 1e300;
-  CompMap::iterator it;
-  for (it = m_other.begin(); it != m_other.end(); ++it) {
-    Nuc nuc = it->first;
-    double qty_other = it->second;
-    if (m.count(nuc) == 0 && qty_other > 0) {
+  const std::vector<Nuc>& nucs = m_other.nucs();
+  const std::vector<double>& vals = m_other.vals();
+  for (int i = 0; i < nucs.size(); ++i) {
+    double qty_other = vals[i];
+    double qty = m.Get(nucs[i]);
+    if (qty == 0 && qty_other > 0) {
       return 0;
     }
-    double qty = m[nuc];
 
     double ratio = qty / qty_other;
     if (ratio < min_ratio) {
       min_ratio = ratio;
-      limiter = nuc;
     }
   }
 
   double mult = min_ratio * qty();
-  compmath::Normalize(&m_other, mult);
   double sum = 0;
-  for (it = m_other.begin(); it != m_other.end(); ++it) {
-    sum += it->second;
+  for (int i = 0; i < vals.size(); ++i) {
+    sum += vals[i] * mult;
   }
   return sum;
 }
@@ -4,11 +4,19 @@
 #include "comp_math.h"
 #include "cyc_limits.h"
 #include "material.h"
+#include "nuc_group.h"
 
 namespace cyclus {
 namespace toolkit {
 
 /// A class that provides convenience methods for querying a material's properties.
+///
+/// Fractions are computed from per-composition aggregates that are built
+/// lazily the first time any query inspects a composition and then shared by
+/// all queries of materials with that composition: the normalized mass and
+/// atom quantities, element totals, and the sum of every NucGroup asked
+/// about.  Since compositions are immutable and shared by many materials,
+/// per time step queries of steady state inventories cost a lookup.
 class MatQuery {
  public:
   /// Creates a new query object inspecting m.
@@ -49,6 +57,25 @@ class MatQuery {
   /// nuc in the material.
   double atom_frac(std::set<Nuc> nucs);
 
+  /// Returns the mass in kg of the nuclides of group g in the material.
+  double mass(const NucGroup& g);
+
+  /// Returns the combined mass fraction of the nuclides of group g in the
+  /// material.
+  double mass_frac(const NucGroup& g);
+
+  /// Returns the combined atom/mole fraction of the nuclides of group g in
+  /// the material.
+  double atom_frac(const NucGroup& g);
+
+  /// Returns the mass fraction of all isotopes of the element with atomic
+  /// number z in the material.
+  double elem_mass_frac(int z);
+
+  /// Returns the atom/mole fraction of all isotopes of the element with
+  /// atomic number z in the material.
+  double elem_atom_frac(int z);
+
   /// Returns true if all nuclide fractions of the material and other
   /// are the same within threshold.
   bool AlmostEq(Material::Ptr other, double threshold = eps_rsrc());
@@ -19,7 +19,9 @@ MatlBuyPolicy::MatlBuyPolicy() :
     throughput_(std::numeric_limits<double>::max()),
     quantize_(-1),
     fill_to_(1),
-    req_when_under_(1) {
+    req_when_under_(1),
+    pool_req_amt_(-1),
+    pool_excl_(false) {
   Warn<EXPERIMENTAL_WARNING>(
       "MatlBuyPolicy is experimental and its API may be subject to change");
 }
@@ -111,6 +113,7 @@ MatlBuyPolicy& MatlBuyPolicy::Set(std::string commod, Composition::Ptr c,
   d.comp = c;
   d.pref = pref;
   commod_details_[commod] = d;
+  port_pool_.clear();
   return *this;
 }
 
@@ -145,31 +148,48 @@ std::set<RequestPortfolio<Material>::Ptr> MatlBuyPolicy::GetMatlRequests() {
   int n_req = NReq();
   LGH(INFO3) << "requesting " << amt << " kg via " << n_req << " request(s)";
 
+  if (req_amt != pool_req_amt_ || excl != pool_excl_) {
+    port_pool_.clear();
+    pool_req_amt_ = req_amt;
+    pool_excl_ = excl;
+  }
+
   // one portfolio for each request
   for (int i = 0; i != n_req; i++) {
-    RequestPortfolio<Material>::Ptr port(new RequestPortfolio<Material>());
-    std::map<int, std::vector<Request<Material>*> > grps;
-    // one request for each commodity
-    std::map<std::string, CommodDetail>::iterator it;
-    for (it = commod_details_.begin(); it != commod_details_.end(); ++it) {
-      std::string commod = it->first;
-      CommodDetail d = it->second;
-      LG(INFO3) << "  - one " << amt << " kg request of " << commod;
-      Material::Ptr m = Material::CreateUntracked(req_amt, d.comp);
-      grps[i].push_back(port->AddRequest(m, this, commod, d.pref, excl));
-    }
+    ports.insert(PooledPort(i, req_amt, excl));
+  }
+
+  return ports;
+}
+
+RequestPortfolio<Material>::Ptr MatlBuyPolicy::PooledPort(int i,
+                                                          double req_amt,
+                                                          bool excl) {
+  if (i < port_pool_.size()) {
+    return port_pool_[i];
+  }
 
-    // if there's more than one commodity, then make them mutual
-    if (grps.size() > 1) {
-      std::map<int, std::vector<Request<Material>*> >::iterator grpit;
-      for (grpit = grps.begin(); grpit != grps.end(); ++grpit) {
-        port->AddMutualReqs(grpit->second);
-      }
+  RequestPortfolio<Material>::Ptr port(new RequestPortfolio<Material>());
+  std::map<int, std::vector<Request<Material>*> > grps;
+  // one request for each commodity
+  std::map<std::string, CommodDetail>::iterator it;
+  for (it = commod_details_.begin(); it != commod_details_.end(); ++it) {
+    std::string commod = it->first;
+    CommodDetail d = it->second;
+    LG(INFO3) << "  - one " << req_amt << " kg request of " << commod;
+    Material::Ptr m = Material::CreateUntracked(req_amt, d.comp);
+    grps[i].push_back(port->AddRequest(m, this, commod, d.pref, excl));
+  }
+
+  // if there's more than one commodity, then make them mutual
+  if (grps.size() > 1) {
+    std::map<int, std::vector<Request<Material>*> >::iterator grpit;
+    for (grpit = grps.begin(); grpit != grps.end(); ++grpit) {
+      port->AddMutualReqs(grpit->second);
     }
-    ports.insert(port);
   }
-  
-  return ports;
+  port_pool_.push_back(port);
+  return port;
 }
 
 void MatlBuyPolicy::AcceptMatlTrades(
@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_TOOLKIT_MATL_BUY_POLICY_H_
 
 #include <string>
+#include <vector>
 
 #include "composition.h"
 #include "material.h"
@@ -162,11 +163,23 @@ class MatlBuyPolicy : public Trader {
   void set_quantize(double x); 
   void set_throughput(double x); 
   
+  /// Returns the i-th pooled portfolio, building it if the pool is smaller.
+  RequestPortfolio<Material>::Ptr PooledPort(int i, double req_amt, bool excl);
+
   ResBuf<Material>* buf_;
   std::string name_;
   double fill_to_, req_when_under_, quantize_, throughput_;
   std::map<Material::Ptr, std::string> rsrc_commods_;
   std::map<std::string, CommodDetail> commod_details_;
+
+  /// Portfolios built by earlier calls to GetMatlRequests.  Steady state
+  /// buyers make the same requests every time step, so the portfolios are
+  /// handed out again until the request quantity, exclusivity, or the
+  /// commodities change.  Quantized buyers whose number of requests varies
+  /// reuse the first NReq portfolios and only build the missing ones.
+  std::vector<RequestPortfolio<Material>::Ptr> port_pool_;
+  double pool_req_amt_;
+  bool pool_excl_;
 };
 
 }  // namespace toolkit
@@ -154,15 +154,22 @@ std::set<BidPortfolio<Material>::Ptr> MatlSellPolicy::GetMatlBids(
       qty = std::min(req->target()->quantity(), limit);
       nbids = excl ? static_cast<int>(std::floor(qty / quantize_)) : 1;
       qty = excl ? quantize_ : qty;
-      for (int i = 0; i < nbids; i++) {
-        m = buf_->Pop();
-        buf_->Push(m);
-        offer = ignore_comp_ ? \
-                Material::CreateUntracked(qty, req->target()->comp()) : \
-                Material::CreateUntracked(qty, m->comp());
+      if (nbids < 1)
+        continue;
+
+      // all quanta are offered as one compact bid with the composition at
+      // the head of the buffer
+      m = buf_->Peek();
+      offer = ignore_comp_ ? \
+              Material::CreateUntracked(qty, req->target()->comp()) : \
+              Material::CreateUntracked(qty, m->comp());
+      if (excl) {
+        port->AddBids(req, offer, this, nbids);
+      } else {
         port->AddBid(req, offer, this, excl);
-        LG(INFO3) << "  - bid " << qty << " kg on a request for " << commod;
       }
+      LG(INFO3) << "  - bid " << nbids << " x " << qty
+                << " kg on a request for " << commod;
     }
   }
   return ports;
@@ -0,0 +1,81 @@
+#include "nuc_group.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "error.h"
+#include "pyne.h"
+
+namespace cyclus {
+namespace toolkit {
+
+static std::atomic<int> next_group_id(1);
+
+NucGroup::NucGroup(const std::set<Nuc>& nucs)
+    : nucs_(nucs.begin(), nucs.end()) {
+  Compile();
+}
+
+NucGroup::NucGroup(const std::set<Nuc>& nucs, const std::set<int>& zs)
+    : nucs_(nucs.begin(), nucs.end()),
+      zs_(zs.begin(), zs.end()) {
+  Compile();
+}
+
+NucGroup::NucGroup(const std::vector<std::string>& names) {
+  for (int i = 0; i < names.size(); ++i) {
+    try {
+      if (pyne::nucname::iselement(names[i])) {
+        zs_.push_back(pyne::nucname::znum(names[i].c_str()));
+      } else {
+        nucs_.push_back(pyne::nucname::id(names[i]));
+      }
+    } catch (std::exception& e) {
+      throw ValueError("invalid nuclide group member '" + names[i] + "'");
+    }
+  }
+  Compile();
+}
+
+static NucGroup* NewActinides() {
+  std::set<int> zs;
+  for (int z = 89; z <= 103; ++z) {
+    zs.insert(z);
+  }
+  return new NucGroup(std::set<Nuc>(), zs);
+}
+
+static NucGroup* NewFissile() {
+  std::set<Nuc> nucs;
+  nucs.insert(922330000);
+  nucs.insert(922350000);
+  nucs.insert(942390000);
+  nucs.insert(942410000);
+  return new NucGroup(nucs);
+}
+
+const NucGroup& NucGroup::Actinides() {
+  static NucGroup* g = NewActinides();
+  return *g;
+}
+
+const NucGroup& NucGroup::Fissile() {
+  static NucGroup* g = NewFissile();
+  return *g;
+}
+
+bool NucGroup::Contains(Nuc nuc) const {
+  return std::binary_search(zs_.begin(), zs_.end(), nuc / 10000000) ||
+         std::binary_search(nucs_.begin(), nucs_.end(), nuc);
+}
+
+void NucGroup::Compile() {
+  std::sort(nucs_.begin(), nucs_.end());
+  nucs_.erase(std::unique(nucs_.begin(), nucs_.end()), nucs_.end());
+  std::sort(zs_.begin(), zs_.end());
+  zs_.erase(std::unique(zs_.begin(), zs_.end()), zs_.end());
+  id_ = next_group_id.fetch_add(1);
+}
+
+}  // namespace toolkit
+}  // namespace cyclus
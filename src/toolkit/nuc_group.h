@@ -0,0 +1,65 @@
+#ifndef CYCLUS_SRC_TOOLKIT_NUC_GROUP_H_
+#define CYCLUS_SRC_TOOLKIT_NUC_GROUP_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "composition.h"
+
+namespace cyclus {
+namespace toolkit {
+
+/// A compiled group of nuclides (and/or whole elements) that material
+/// queries can sum over.  Names are parsed and members sorted once when the
+/// group is built, and every group gets a unique id so that MatQuery can
+/// remember a group's sum for each composition it has seen.  Archetypes that
+/// check the same group every time step should build it once (e.g. as a
+/// member) and reuse it rather than passing a new std::set<Nuc> each time.
+///
+/// @code
+/// std::vector<std::string> names;
+/// names.push_back("Pu");     // every plutonium isotope
+/// names.push_back("Am241");
+/// NucGroup g(names);
+/// double frac = MatQuery(mat).mass_frac(g);
+/// @endcode
+class NucGroup {
+ public:
+  /// Creates a group of the nuclides nucs.
+  explicit NucGroup(const std::set<Nuc>& nucs);
+
+  /// Creates a group from nuclide or element names (e.g. "U235", "Pu").
+  /// Element names stand for every isotope of the element.
+  /// @throws ValueError if a name is neither a nuclide nor an element
+  explicit NucGroup(const std::vector<std::string>& names);
+
+  /// Creates a group of nuclides nucs and every isotope of the elements
+  /// with atomic numbers zs.
+  NucGroup(const std::set<Nuc>& nucs, const std::set<int>& zs);
+
+  /// Returns the group of all actinides (elements 89 through 103).
+  static const NucGroup& Actinides();
+
+  /// Returns the group of the common fissile nuclides U-233, U-235, Pu-239
+  /// and Pu-241.
+  static const NucGroup& Fissile();
+
+  /// Returns a unique id shared by copies of this group.
+  int id() const { return id_; }
+
+  /// Returns true if nuc is a member of the group.
+  bool Contains(Nuc nuc) const;
+
+ private:
+  void Compile();
+
+  std::vector<Nuc> nucs_;
+  std::vector<int> zs_;
+  int id_;
+};
+
+}  // namespace toolkit
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_TOOLKIT_NUC_GROUP_H_
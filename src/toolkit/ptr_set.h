@@ -0,0 +1,122 @@
+#ifndef CYCLUS_SRC_TOOLKIT_PTR_SET_H_
+#define CYCLUS_SRC_TOOLKIT_PTR_SET_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace cyclus {
+namespace toolkit {
+
+/// PtrSet is a set of object addresses stored in a flat open addressing
+/// (linear probing) hash table.  Unlike std::set or std::unordered_set,
+/// inserts and erases never allocate a node; the table only reallocates
+/// when it grows, and lookups touch one or two cache lines.  It is used for
+/// membership checks such as ResBuf's duplicate push detection.  Null is
+/// not a valid member.
+class PtrSet {
+ public:
+  PtrSet() : size_(0) {}
+
+  /// Returns the number of members.
+  inline std::size_t size() const { return size_; }
+
+  /// Returns true if p is a member.
+  bool count(const void* p) const {
+    if (size_ == 0) {
+      return false;
+    }
+    for (std::size_t i = Home(p);; i = Next(i)) {
+      if (slots_[i] == p) {
+        return true;
+      } else if (slots_[i] == NULL) {
+        return false;
+      }
+    }
+  }
+
+  /// Adds p, returning false if it was already a member.
+  bool insert(const void* p) {
+    // keep the load factor at or below 1/2 so probe sequences stay short
+    if (2 * (size_ + 1) > slots_.size()) {
+      Rehash(slots_.empty() ? 16 : 2 * slots_.size());
+    }
+    std::size_t i = Home(p);
+    for (; slots_[i] != NULL; i = Next(i)) {
+      if (slots_[i] == p) {
+        return false;
+      }
+    }
+    slots_[i] = p;
+    ++size_;
+    return true;
+  }
+
+  /// Removes p, returning false if it was not a member.
+  bool erase(const void* p) {
+    if (size_ == 0) {
+      return false;
+    }
+    std::size_t i = Home(p);
+    for (; slots_[i] != p; i = Next(i)) {
+      if (slots_[i] == NULL) {
+        return false;
+      }
+    }
+
+    // shift later members of the probe run back into the hole instead of
+    // leaving a tombstone, so lookups never slow down with churn
+    std::size_t hole = i;
+    for (std::size_t j = Next(i); slots_[j] != NULL; j = Next(j)) {
+      std::size_t home = Home(slots_[j]);
+      // j may move to the hole only if its home is not cyclically in
+      // (hole, j]
+      bool stays = hole <= j ? (hole < home && home <= j)
+                             : (hole < home || home <= j);
+      if (!stays) {
+        slots_[hole] = slots_[j];
+        hole = j;
+      }
+    }
+    slots_[hole] = NULL;
+    --size_;
+    return true;
+  }
+
+  /// Removes all members, keeping the allocated table.
+  void clear() {
+    slots_.assign(slots_.size(), static_cast<const void*>(NULL));
+    size_ = 0;
+  }
+
+ private:
+  inline std::size_t Home(const void* p) const {
+    // Fibonacci hashing of the address; the low bits are mostly alignment
+    uint64_t h = reinterpret_cast<uintptr_t>(p) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(h >> 32) & (slots_.size() - 1);
+  }
+
+  inline std::size_t Next(std::size_t i) const {
+    return (i + 1) & (slots_.size() - 1);
+  }
+
+  void Rehash(std::size_t n) {
+    std::vector<const void*> old(n, static_cast<const void*>(NULL));
+    old.swap(slots_);
+    size_ = 0;
+    for (std::size_t i = 0; i < old.size(); ++i) {
+      if (old[i] != NULL) {
+        insert(old[i]);
+      }
+    }
+  }
+
+  /// always empty or a power of two in size
+  std::vector<const void*> slots_;
+  std::size_t size_;
+};
+
+}  // namespace toolkit
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_TOOLKIT_PTR_SET_H_
@@ -3,8 +3,6 @@
 
 #include <iomanip>
 #include <limits>
-#include <list>
-#include <set>
 #include <vector>
 
 #include "cyc_arithmetic.h"
@@ -12,8 +10,10 @@
 #include "error.h"
 #include "product.h"
 #include "material.h"
+#include "ptr_set.h"
 #include "resource.h"
 #include "res_manip.h"
+#include "ring_buf.h"
 
 namespace cyclus {
 namespace toolkit {
@@ -58,6 +58,11 @@ typedef std::vector<Product::Ptr> ProdVec;
 /// In this example, if there is sufficient material in inventory_, 2703 kg is
 /// removed as a single object that is then placed in another buffer
 /// (outventory_) each time step.
+///
+/// Resources are stored in a contiguous ring buffer with a flat hash set of
+/// their addresses for duplicate detection, so pushing and popping doesn't
+/// allocate once the buffer has reached its working size.  The total
+/// quantity is kept as a compensated running sum.
 template <class T>
 class ResBuf {
  public:
@@ -91,12 +96,12 @@ class ResBuf {
 
   /// Returns the total resource quantity of constituent resource
   /// objects in the buffer. Never throws.
-  inline double quantity() const { return qty_; }
+  inline double quantity() const { return qty_.value(); }
 
   /// Returns the quantity of space remaining in this buffer.
   /// This is effectively the difference between the capacity and the quantity
   /// and is never negative. Never throws.
-  inline double space() const { return std::max(0.0, cap_ - qty_); }
+  inline double space() const { return std::max(0.0, cap_ - quantity()); }
 
   /// Returns true if there are no resources in the buffer.
   inline bool empty() const { return rs_.empty(); }
@@ -106,7 +111,7 @@ class ResBuf {
   /// Resources are split if necessary in order to pop the exact quantity
   /// requested (within eps_rsrc()).  Resources are retrieved in the order they
   /// were pushed (i.e. oldest first) and are squashed into a single object
-  /// when returned.
+  /// when returned, in one merge rather than one per popped resource.
   ///
   /// @throws ValueError the specified pop quantity is larger than the
   /// buffer's current inventory.
@@ -120,23 +125,20 @@ class ResBuf {
 
     std::vector<typename T::Ptr> rs;
     typename T::Ptr r;
-    typename T::Ptr tmp;
     double left = qty;
     double quan;
     while (left > 0 && count() > 0) {
       r = rs_.front();
-      rs_.pop_front();
       quan = r->quantity();
       if (quan > left) {
-        // too big - split the res before popping
-        tmp = boost::dynamic_pointer_cast<T>(r->ExtractRes(left));
-        rs_.push_front(r);
-        r = tmp;
+        // too big - split the res, leaving the rest at the front
+        r = boost::dynamic_pointer_cast<T>(r->ExtractRes(left));
       } else {
-        rs_present_.erase(r);
+        rs_.pop_front();
+        rs_present_.erase(r.get());
       }
 
-      qty_ -= r->quantity();
+      qty_.Add(-r->quantity());
       rs.push_back(r);
       left -= quan;
     }
@@ -177,12 +179,13 @@ class ResBuf {
     }
 
     std::vector<typename T::Ptr> rs;
+    rs.reserve(n);
     for (int i = 0; i < n; i++) {
       typename T::Ptr r = rs_.front();
-      qty_ -= r->quantity();
+      qty_.Add(-r->quantity());
       rs_.pop_front();
+      rs_present_.erase(r.get());
       rs.push_back(r);
-      rs_present_.erase(r);
     }
 
     UpdateQty();
@@ -213,8 +216,8 @@ class ResBuf {
 
     typename T::Ptr r = rs_.front();
     rs_.pop_front();
-    rs_present_.erase(r);
-    qty_ -= r->quantity();
+    rs_present_.erase(r.get());
+    qty_.Add(-r->quantity());
     UpdateQty();
     return r;
   }
@@ -227,8 +230,8 @@ class ResBuf {
 
     typename T::Ptr r = rs_.back();
     rs_.pop_back();
-    rs_present_.erase(r);
-    qty_ -= r->quantity();
+    rs_present_.erase(r.get());
+    qty_.Add(-r->quantity());
     UpdateQty();
     return r;
   }
@@ -252,13 +255,13 @@ class ResBuf {
       ss << "resource pushing breaks capacity limit: space=" << space()
          << ", rsrc->quantity()=" << r->quantity();
       throw ValueError(ss.str());
-    } else if (rs_present_.count(m) == 1) {
+    } else if (rs_present_.count(m.get())) {
       throw KeyError("duplicate resource push attempted");
     }
 
     rs_.push_back(m);
-    rs_present_.insert(m);
-    qty_ += r->quantity();
+    rs_present_.insert(m.get());
+    qty_.Add(r->quantity());
     UpdateQty();
   }
 
@@ -276,6 +279,7 @@ class ResBuf {
   template <class B>
   void Push(std::vector<B> rs) {
     std::vector<typename T::Ptr> rss;
+    rss.reserve(rs.size());
     typename T::Ptr r;
     for (int i = 0; i < rs.size(); i++) {
       r = boost::dynamic_pointer_cast<T>(rs[i]);
@@ -285,45 +289,48 @@ class ResBuf {
       rss.push_back(r);
     }
 
-    double tot_qty = 0;
+    CompensatedSum tot_qty;
     for (int i = 0; i < rss.size(); i++) {
-      tot_qty += rss.at(i)->quantity();
+      tot_qty.Add(rss[i]->quantity());
     }
-    if (tot_qty - space() > eps_rsrc()) {
+    if (tot_qty.value() - space() > eps_rsrc()) {
       throw ValueError("Resource pushing breaks capacity limit.");
     }
 
     for (int i = 0; i < rss.size(); i++) {
-      if (rs_present_.count(rss.at(i)) == 1) {
+      if (rs_present_.count(rss[i].get())) {
         throw KeyError("Duplicate resource pushing attempted");
       }
     }
 
     for (int i = 0; i < rss.size(); i++) {
       rs_.push_back(rss[i]);
-      rs_present_.insert(rss[i]);
+      rs_present_.insert(rss[i].get());
+      qty_.Add(rss[i]->quantity());
     }
-    qty_ += tot_qty;
   }
 
  private:
   void UpdateQty() {
     int n = rs_.size();
     if (n == 0) {
-      qty_ = 0;
+      qty_.Reset();
     } else if (n == 1) {
-      qty_ = rs_.front()->quantity();
+      qty_.Reset(rs_.front()->quantity());
     }
   }
 
-  double qty_;
+  CompensatedSum qty_;
 
   /// Maximum quantity of resources this buffer can hold
   double cap_;
 
-  /// List of constituent resource objects forming the buffer's inventory
-  std::list<typename T::Ptr> rs_;
-  std::set<typename T::Ptr> rs_present_;
+  /// Constituent resource objects forming the buffer's inventory, oldest
+  /// first
+  RingBuf<typename T::Ptr> rs_;
+
+  /// Addresses of the resources in rs_
+  PtrSet rs_present_;
 };
 
 }  // namespace toolkit
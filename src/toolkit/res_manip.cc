@@ -10,9 +10,7 @@ Product::Ptr Squash(std::vector<Product::Ptr> ps) {
   }
 
   Product::Ptr p = ps[0];
-  for (int i = 1; i < ps.size(); ++i) {
-    p->Absorb(ps[i]);
-  }
+  p->Absorb(std::vector<Product::Ptr>(ps.begin() + 1, ps.end()));
   return p;
 }
 
@@ -22,9 +20,7 @@ Material::Ptr Squash(std::vector<Material::Ptr> ms) {
   }
 
   Material::Ptr m = ms[0];
-  for (int i = 1; i < ms.size(); ++i) {
-    m->Absorb(ms[i]);
-  }
+  m->Absorb(std::vector<Material::Ptr>(ms.begin() + 1, ms.end()));
   return m;
 }
 
@@ -13,7 +13,9 @@ namespace toolkit {
 Product::Ptr Squash(std::vector<Product::Ptr> ps);
 
 /// Squash combines all materials in ms and returns the resulting single
-/// material.
+/// material.  The first material absorbs the rest in a single n-ary merge
+/// (see Material::Absorb), so only one composition and resource state is
+/// created however many materials are squashed.
 Material::Ptr Squash(std::vector<Material::Ptr> ms);
 
 /// Squash combines all resources in rs and returns the resulting single
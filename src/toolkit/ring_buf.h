@@ -0,0 +1,103 @@
+#ifndef CYCLUS_SRC_TOOLKIT_RING_BUF_H_
+#define CYCLUS_SRC_TOOLKIT_RING_BUF_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace cyclus {
+namespace toolkit {
+
+/// RingBuf is a double ended queue stored in one contiguous, growable
+/// circular array.  Pushing and popping at either end is O(1) and never
+/// allocates unless the buffer has to grow, so long lived queues that are
+/// constantly filled and drained (e.g. ResBuf inventories) stop allocating
+/// once they reach their working size.  Popped slots are reset to T() so
+/// that e.g. shared pointers are released immediately.
+template <class T>
+class RingBuf {
+ public:
+  RingBuf() : head_(0), size_(0) {}
+
+  /// Returns the number of elements.
+  inline std::size_t size() const { return size_; }
+
+  /// Returns true if there are no elements.
+  inline bool empty() const { return size_ == 0; }
+
+  /// Returns the number of elements that fit before the buffer grows.
+  inline std::size_t capacity() const { return buf_.size(); }
+
+  /// Returns the i-th element from the front.  i must be less than size().
+  inline T& operator[](std::size_t i) { return buf_[Slot(i)]; }
+  inline const T& operator[](std::size_t i) const { return buf_[Slot(i)]; }
+
+  /// Returns the first element.  The buffer must not be empty.
+  inline T& front() { return buf_[head_]; }
+  inline const T& front() const { return buf_[head_]; }
+
+  /// Returns the last element.  The buffer must not be empty.
+  inline T& back() { return buf_[Slot(size_ - 1)]; }
+  inline const T& back() const { return buf_[Slot(size_ - 1)]; }
+
+  void push_back(const T& v) {
+    if (size_ == buf_.size()) {
+      Grow();
+    }
+    buf_[Slot(size_)] = v;
+    ++size_;
+  }
+
+  void push_front(const T& v) {
+    if (size_ == buf_.size()) {
+      Grow();
+    }
+    head_ = (head_ + buf_.size() - 1) & (buf_.size() - 1);
+    buf_[head_] = v;
+    ++size_;
+  }
+
+  /// Removes the first element.  The buffer must not be empty.
+  void pop_front() {
+    buf_[head_] = T();
+    head_ = (head_ + 1) & (buf_.size() - 1);
+    --size_;
+  }
+
+  /// Removes the last element.  The buffer must not be empty.
+  void pop_back() {
+    buf_[Slot(size_ - 1)] = T();
+    --size_;
+  }
+
+  /// Removes all elements, keeping the allocated storage.
+  void clear() {
+    while (size_ > 0) {
+      pop_back();
+    }
+    head_ = 0;
+  }
+
+ private:
+  /// the capacity is always zero or a power of two so slots wrap with a mask
+  inline std::size_t Slot(std::size_t i) const {
+    return (head_ + i) & (buf_.size() - 1);
+  }
+
+  void Grow() {
+    std::vector<T> grown(buf_.empty() ? 8 : 2 * buf_.size());
+    for (std::size_t i = 0; i < size_; ++i) {
+      grown[i] = buf_[Slot(i)];
+    }
+    buf_.swap(grown);
+    head_ = 0;
+  }
+
+  std::vector<T> buf_;
+  std::size_t head_;
+  std::size_t size_;
+};
+
+}  // namespace toolkit
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_TOOLKIT_RING_BUF_H_
@@ -6,13 +6,84 @@ namespace cyclus {
 namespace toolkit {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double SupplyDemandManager::Supply(Commodity& commodity) {
-  double value = 0.0;
+SupplyDemandManager::SupplyDemandManager(const SupplyDemandManager& other)
+    : AgentManaged(other),
+      demand_functions_(other.demand_functions_) {
+  std::set<CommodityProducerManager*>::const_iterator it;
+  for (it = other.managers_.begin(); it != other.managers_.end(); ++it) {
+    RegisterProducerManager(*it);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SupplyDemandManager& SupplyDemandManager::operator=(
+    const SupplyDemandManager& other) {
+  if (this == &other) {
+    return *this;
+  }
+  AgentManaged::operator=(other);
+  demand_functions_ = other.demand_functions_;
+  std::set<CommodityProducerManager*> old = managers_;
+  std::set<CommodityProducerManager*>::const_iterator it;
+  for (it = old.begin(); it != old.end(); ++it) {
+    UnregisterProducerManager(*it);
+  }
+  for (it = other.managers_.begin(); it != other.managers_.end(); ++it) {
+    RegisterProducerManager(*it);
+  }
+  return *this;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SupplyDemandManager::~SupplyDemandManager() {
   std::set<CommodityProducerManager*>::iterator it;
-  for (it = managers_.begin(); it != managers_.end(); it++) {
-    value += (*it)->TotalCapacity(commodity);
+  for (it = managers_.begin(); it != managers_.end(); ++it) {
+    (*it)->sd_managers_.erase(this);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SupplyDemandManager::RegisterProducerManager(
+    CommodityProducerManager* cpm) {
+  if (!managers_.insert(cpm).second) {
+    return;
+  }
+  cpm->sd_managers_.insert(this);
+  std::map<Commodity, SupplyTotal, CommodityCompare>::iterator it;
+  for (it = cpm->totals_.begin(); it != cpm->totals_.end(); ++it) {
+    Changed(it->first, it->second.capacity.value(), it->second.nproducers);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SupplyDemandManager::UnregisterProducerManager(
+    CommodityProducerManager* cpm) {
+  if (managers_.erase(cpm) == 0) {
+    return;
+  }
+  cpm->sd_managers_.erase(this);
+  std::map<Commodity, SupplyTotal, CommodityCompare>::iterator it;
+  for (it = cpm->totals_.begin(); it != cpm->totals_.end(); ++it) {
+    Changed(it->first, -it->second.capacity.value(), -it->second.nproducers);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double SupplyDemandManager::Supply(Commodity& commodity) {
+  std::map<Commodity, SupplyTotal, CommodityCompare>::iterator it =
+      totals_.find(commodity);
+  return it == totals_.end() ? 0.0 : it->second.capacity.value();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SupplyDemandManager::Changed(const Commodity& commodity, double dcap,
+                                  int dcount) {
+  SupplyTotal& t = totals_[commodity];
+  t.capacity.Add(dcap);
+  t.nproducers += dcount;
+  if (t.nproducers == 0) {
+    totals_.erase(commodity);
   }
-  return value;
 }
 
 }  // namespace toolkit
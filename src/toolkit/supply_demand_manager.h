@@ -20,10 +20,23 @@ namespace toolkit {
 /// provides the demand and supply of a commodity at a given time.
 /// What to do with this information is left to the user of the
 /// SupplyDemandManager.
+///
+/// Supply is kept as a running total per commodity that the registered
+/// producer managers update as their producers change, so querying it
+/// doesn't visit the managers.
 class SupplyDemandManager : public AgentManaged {
+  friend class CommodityProducerManager;
+
  public:
   SupplyDemandManager(Agent* agent = NULL) : AgentManaged(agent) {}
-  virtual ~SupplyDemandManager() {}
+
+  /// Registers the producer managers of other with the new manager.
+  SupplyDemandManager(const SupplyDemandManager& other);
+
+  SupplyDemandManager& operator=(const SupplyDemandManager& other);
+
+  /// Detaches from the registered producer managers.
+  virtual ~SupplyDemandManager();
 
   /// Register a new commodity with the manager, along with all the
   /// necessary information.
@@ -41,15 +54,11 @@ class SupplyDemandManager : public AgentManaged {
   }
 
   /// Adds a commodity producer manager to the set of producer managers
-  inline void RegisterProducerManager(CommodityProducerManager* cpm) {
-    managers_.insert(cpm);
-  }
+  void RegisterProducerManager(CommodityProducerManager* cpm);
 
   /// Removes a commodity producer manager from the set of producer
   /// managers
-  inline void UnregisterProducerManager(CommodityProducerManager* cpm) {
-    managers_.erase(cpm);
-  }
+  void UnregisterProducerManager(CommodityProducerManager* cpm);
 
   /// The demand for a commodity at a given time
   /// @param commodity the commodity
@@ -70,11 +79,17 @@ class SupplyDemandManager : public AgentManaged {
   double Supply(Commodity& commodity);
 
  private:
+  /// Applies a change of dcap capacity and dcount producers of commodity.
+  void Changed(const Commodity& commodity, double dcap, int dcount);
+
   /// A container of all demand functions known to the manager
   std::map<Commodity, SymFunction::Ptr, CommodityCompare> demand_functions_;
 
   /// A container of all production managers known to the manager
   std::set<CommodityProducerManager*> managers_;
+
+  /// The running supply totals of the producer managers
+  std::map<Commodity, SupplyTotal, CommodityCompare> totals_;
 };
 
 }  // namespace toolkit
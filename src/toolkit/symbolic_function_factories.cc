@@ -71,6 +71,7 @@ void PiecewiseFunctionFactory::AddFunction(SymFunction::Ptr function,
 
   function_->functions_.push_back(PiecewiseFunction::PiecewiseFunctionInfo(
                                       function, starting_coord, yoffset));
+  function_->compiled_ = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
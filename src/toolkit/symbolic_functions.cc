@@ -1,5 +1,6 @@
 #include "symbolic_functions.h"
 
+#include <algorithm>
 #include <limits>
 #include <math.h>
 #include <sstream>
@@ -8,6 +9,15 @@
 namespace cyclus {
 namespace toolkit {
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> SymFunction::values(const std::vector<double>& xs) {
+  std::vector<double> ys(xs.size());
+  for (int i = 0; i < xs.size(); ++i) {
+    ys[i] = value(xs[i]);
+  }
+  return ys;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double LinearFunction::value(double x) {
   return slope_ * x + intercept_;
@@ -35,18 +45,116 @@ std::string ExponentialFunction::Print() {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double PiecewiseFunction::value(double x) {
-  double ret;
-  if (functions_.empty() || (x < functions_.front().xoffset)) {
-    ret = 0.0;
-  } else {
-    std::list<PiecewiseFunctionInfo>::iterator f = functions_.begin();
-    while (f != functions_.end() && (x >= f->xoffset)) {
-      ++f;  // exceeds search by 1
+  Compile();
+  // the last piece starting at or before x
+  int i = std::upper_bound(starts_.begin(), starts_.end(), x) -
+          starts_.begin() - 1;
+  return i < 0 ? 0.0 : Eval(i, x);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<double> PiecewiseFunction::values(const std::vector<double>& xs) {
+  Compile();
+  std::vector<double> ys(xs.size());
+  int n = starts_.size();
+  int i = -1;
+  for (int j = 0; j < xs.size(); ++j) {
+    double x = xs[j];
+    if ((i >= 0 && x < starts_[i]) || (i < 0 && n > 0 && x >= starts_[0])) {
+      i = std::upper_bound(starts_.begin(), starts_.end(), x) -
+          starts_.begin() - 1;
     }
-    --f;  // go back to the correct one
-    ret = f->function->value(x - f->xoffset) + f->yoffset;
+    while (i >= 0 && i + 1 < n && x >= starts_[i + 1]) {
+      ++i;
+    }
+    ys[j] = i < 0 ? 0.0 : Eval(i, x);
+  }
+  return ys;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PiecewiseFunction::Compile() {
+  if (compiled_) {
+    return;
+  }
+  starts_.clear();
+  pieces_.clear();
+  Flatten(functions_, 0, 0, std::numeric_limits<double>::infinity());
+  compiled_ = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PiecewiseFunction::Flatten(const std::list<PiecewiseFunctionInfo>& fs,
+                                double x0, double y0, double end) {
+  std::list<PiecewiseFunctionInfo>::const_iterator f, next;
+  for (f = fs.begin(); f != fs.end(); f = next) {
+    next = f;
+    ++next;
+    // a nested function's pieces can't start before its parent piece
+    double xoffset = x0 + f->xoffset;
+    double start = starts_.empty() ? xoffset
+                                   : std::max(xoffset, starts_.back());
+    double stop = next == fs.end() ? end : std::min(end, x0 + next->xoffset);
+    if (start >= end) {
+      break;
+    } else if (start >= stop) {
+      continue;
+    }
+
+    Piece p;
+    p.xoffset = xoffset;
+    p.yoffset = y0 + f->yoffset;
+    p.a = p.b = p.c = 0;
+    SymFunction* fn = f->function.get();
+    if (LinearFunction* lin = dynamic_cast<LinearFunction*>(fn)) {
+      p.kind = Piece::LINEAR;
+      p.a = lin->slope();
+      p.c = lin->intercept();
+      AddPiece(start, p);
+    } else if (ExponentialFunction* e = dynamic_cast<ExponentialFunction*>(fn)) {
+      p.kind = Piece::EXPONENTIAL;
+      p.a = e->constant();
+      p.b = e->exponent();
+      p.c = e->intercept();
+      AddPiece(start, p);
+    } else if (PiecewiseFunction* pw = dynamic_cast<PiecewiseFunction*>(fn)) {
+      // a nested piecewise function is zero before its first piece
+      p.kind = Piece::CONSTANT;
+      AddPiece(start, p);
+      Flatten(pw->functions_, xoffset, p.yoffset, stop);
+    } else {
+      p.kind = Piece::OTHER;
+      p.function = f->function;
+      AddPiece(start, p);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PiecewiseFunction::AddPiece(double x, const Piece& p) {
+  // a nested function's pieces replace the ones they start with
+  if (!starts_.empty() && starts_.back() == x) {
+    pieces_.back() = p;
+    return;
+  }
+  starts_.push_back(x);
+  pieces_.push_back(p);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double PiecewiseFunction::Eval(int i, double x) const {
+  const Piece& p = pieces_[i];
+  double u = x - p.xoffset;
+  switch (p.kind) {
+    case Piece::LINEAR:
+      return (p.a * u + p.c) + p.yoffset;
+    case Piece::EXPONENTIAL:
+      return (p.a * exp(p.b * u) + p.c) + p.yoffset;
+    case Piece::CONSTANT:
+      return p.yoffset;
+    default:
+      return p.function->value(u) + p.yoffset;
   }
-  return ret;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
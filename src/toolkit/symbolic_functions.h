@@ -3,6 +3,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
@@ -25,6 +26,10 @@ class SymFunction {
   /// Base class must define how to calculate demand (dbl argument)
   virtual double value(double x) = 0;
 
+  /// Returns the value of the function at each of xs, e.g. to precompute
+  /// demand over a whole simulation horizon.
+  virtual std::vector<double> values(const std::vector<double>& xs);
+
   /// Every function must print itself
   virtual std::string Print() = 0;
 };
@@ -44,6 +49,12 @@ class LinearFunction : public SymFunction {
   /// Print a string of the function
   virtual std::string Print();
 
+  /// @return the slope
+  double slope() const { return slope_; }
+
+  /// @return the intercept
+  double intercept() const { return intercept_; }
+
  private:
   /// The slope
   double slope_;
@@ -71,6 +82,15 @@ class ExponentialFunction : public SymFunction {
   /// Print a string of the function
   virtual std::string Print();
 
+  /// @return the leading constant
+  double constant() const { return constant_; }
+
+  /// @return the exponent multiplier
+  double exponent() const { return exponent_; }
+
+  /// @return the intercept
+  double intercept() const { return intercept_; }
+
  private:
   /// The constant factor
   double constant_;
@@ -85,6 +105,15 @@ class ExponentialFunction : public SymFunction {
 /// Piecewise function
 /// f(x) for all x in [lhs,rhs]
 /// 0 otherwise
+///
+/// Before it is first evaluated, the function is compiled into a flat table
+/// of pieces sorted by their starting coordinate.  Linear, exponential and
+/// nested piecewise sub-functions are inlined as coefficients, so evaluating
+/// the function is a binary search and a few arithmetic operations instead
+/// of a walk over the sub-functions and virtual calls.  Other sub-function
+/// types are still called through SymFunction.  Nested piecewise functions
+/// are copied into the table when compiling, so they must be complete by
+/// then.
 class PiecewiseFunction : public SymFunction {
   struct PiecewiseFunctionInfo {
     PiecewiseFunctionInfo(SymFunction::Ptr function_, double xoff_ = 0,
@@ -97,16 +126,55 @@ class PiecewiseFunction : public SymFunction {
     double xoffset, yoffset;
   };
 
+  /// A piece of the compiled function, whose value at x is
+  /// term(x - xoffset) + yoffset.
+  struct Piece {
+    enum Kind { CONSTANT, LINEAR, EXPONENTIAL, OTHER };
+
+    Kind kind;
+    double xoffset, yoffset;
+    /// slope and intercept (LINEAR) or constant, exponent and intercept
+    /// (EXPONENTIAL)
+    double a, b, c;
+    /// the sub-function of OTHER pieces
+    SymFunction::Ptr function;
+  };
+
  public:
+  PiecewiseFunction() : compiled_(false) {}
+
   /// Evaluation for an double argument
   virtual double value(double x);
 
+  /// Evaluation for many arguments.  Ascending xs are evaluated with a
+  /// single forward walk over the pieces.
+  virtual std::vector<double> values(const std::vector<double>& xs);
+
   /// Print a string of the function
   virtual std::string Print();
 
+  /// Builds the breakpoint table, if it isn't built yet.  Called
+  /// automatically by value and values.
+  void Compile();
+
  private:
+  /// Appends the pieces of fs, shifted by (x0, y0), that start before end.
+  void Flatten(const std::list<PiecewiseFunctionInfo>& fs, double x0,
+               double y0, double end);
+
+  /// Appends a piece starting at x.
+  void AddPiece(double x, const Piece& p);
+
+  /// Evaluates piece i at x.
+  double Eval(int i, double x) const;
+
   std::list<PiecewiseFunctionInfo> functions_;
 
+  /// the compiled table: piece i applies from starts_[i] up to starts_[i+1]
+  bool compiled_;
+  std::vector<double> starts_;
+  std::vector<Piece> pieces_;
+
   friend class PiecewiseFunctionFactory;
 };
 
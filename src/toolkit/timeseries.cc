@@ -1,21 +1,170 @@
 #include "timeseries.h"
 
+#include "datum.h"
+#include "error.h"
+#include "logger.h"
+
 namespace cyclus {
 namespace toolkit {
 
+std::string TimeSeriesName(TimeSeriesType t) {
+  switch (t) {
+    case POWER:
+      return "Power";
+    case ENRICH_SWU:
+      return "EnrichmentSWU";
+    case ENRICH_FEED:
+      return "EnrichmentFeed";
+  }
+  throw ValueError("unknown time series type");
+}
+
 template <>
 void RecordTimeSeries<POWER>(cyclus::Agent* agent, double value) {
-  RecordTimeSeries<double>("Power", agent, value);
+  RecordTimeSeries<double>(TimeSeriesName(POWER), agent, value);
 }
 
 template <>
 void RecordTimeSeries<ENRICH_SWU>(cyclus::Agent* agent, double value) {
-  RecordTimeSeries<double>("EnrichmentSWU", agent, value);
+  RecordTimeSeries<double>(TimeSeriesName(ENRICH_SWU), agent, value);
 }
 
 template <>
 void RecordTimeSeries<ENRICH_FEED>(cyclus::Agent* agent, double value) {
-  RecordTimeSeries<double>("EnrichmentFeed", agent, value);
+  RecordTimeSeries<double>(TimeSeriesName(ENRICH_FEED), agent, value);
+}
+
+TimeSeriesAccumulator::TimeSeriesAccumulator(Context* ctx,
+                                             std::string tsname,
+                                             TimeSeriesAgg agg, int nsteps,
+                                             int batch)
+    : ctx_(ctx),
+      tblname_("TimeSeries" + tsname),
+      agg_(agg) {
+  Init(nsteps, batch);
+}
+
+TimeSeriesAccumulator::TimeSeriesAccumulator(Context* ctx, TimeSeriesType t,
+                                             TimeSeriesAgg agg, int nsteps,
+                                             int batch)
+    : ctx_(ctx),
+      tblname_("TimeSeries" + TimeSeriesName(t)),
+      agg_(agg) {
+  Init(nsteps, batch);
+}
+
+void TimeSeriesAccumulator::Init(int nsteps, int batch) {
+  if (nsteps < 1 || batch < 1) {
+    throw ValueError("time series windows and batches must be positive");
+  }
+  nsteps_ = nsteps;
+  batch_ = batch;
+  ctx_->RegisterOutputBuffer(this);
+  agent_ids_.reserve(batch);
+  times_.reserve(batch);
+  values_.reserve(batch);
+  if (agg_ != TS_RAW) {
+    steps_.reserve(batch);
+  }
+}
+
+TimeSeriesAccumulator::~TimeSeriesAccumulator() {
+  ctx_->UnregisterOutputBuffer(this);
+  try {
+    Flush();
+  } catch (Error err) {
+    CLOG(LEV_ERROR) << "Error flushing time series " << tblname_ << ": "
+                    << err.what();
+  }
+}
+
+void TimeSeriesAccumulator::Add(Agent* agent, double value) {
+  int t = ctx_->time();
+  if (agg_ == TS_RAW) {
+    Push(agent->id(), t, value, 1);
+    return;
+  }
+
+  Open& o = open_[agent->id()];
+  if (agg_ == TS_CHANGES) {
+    if (o.nvals > 0 && value != o.last) {
+      Close(agent->id(), &o);
+    }
+    if (o.nvals == 0) {
+      o.start = t;
+      o.last = value;
+    }
+  } else {
+    int w = t / nsteps_;
+    if (o.nvals > 0 && w != o.window) {
+      Close(agent->id(), &o);
+    }
+    if (o.nvals == 0) {
+      o.window = w;
+      o.start = w * nsteps_;
+    }
+    o.sum += value;
+  }
+  ++o.nvals;
+}
+
+void TimeSeriesAccumulator::Flush() {
+  std::map<int, Open>::iterator it;
+  for (it = open_.begin(); it != open_.end(); ++it) {
+    if (it->second.nvals > 0) {
+      Close(it->first, &it->second);
+    }
+  }
+  open_.clear();
+  Record();
+}
+
+void TimeSeriesAccumulator::Push(int agent_id, int time, double value,
+                                 int steps) {
+  agent_ids_.push_back(agent_id);
+  times_.push_back(time);
+  values_.push_back(value);
+  if (agg_ != TS_RAW) {
+    steps_.push_back(steps);
+  }
+  if (agent_ids_.size() >= batch_) {
+    Record();
+  }
+}
+
+void TimeSeriesAccumulator::Close(int agent_id, Open* o) {
+  double value;
+  switch (agg_) {
+    case TS_SUM:
+      value = o->sum;
+      break;
+    case TS_MEAN:
+      value = o->sum / o->nvals;
+      break;
+    default:
+      value = o->last;
+  }
+  int nvals = o->nvals;
+  o->nvals = 0;
+  o->sum = 0;
+  Push(agent_id, o->start, value, nvals);
+}
+
+void TimeSeriesAccumulator::Record() {
+  for (int i = 0; i < agent_ids_.size(); ++i) {
+    Datum* d = ctx_->NewDatum(tblname_)
+                   ->AddVal("AgentId", agent_ids_[i])
+                   ->AddVal("Time", times_[i])
+                   ->AddVal("Value", values_[i]);
+    if (agg_ != TS_RAW) {
+      d->AddVal("Steps", steps_[i]);
+    }
+    d->Record();
+  }
+  agent_ids_.clear();
+  times_.clear();
+  values_.clear();
+  steps_.clear();
 }
 
 }  // namespace toolkit
@@ -1,7 +1,9 @@
 #ifndef CYCLUS_SRC_TOOLKIT_TIMESERIES_H_
 #define CYCLUS_SRC_TOOLKIT_TIMESERIES_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "agent.h"
 #include "context.h"
@@ -20,6 +22,10 @@ enum TimeSeriesType {
   ENRICH_FEED,
 };
 
+/// Returns the name of the table suffix used for a time series type (e.g.
+/// "Power" for POWER).
+std::string TimeSeriesName(TimeSeriesType t);
+
 /// Records a per-time step quantity for a given type
 template <TimeSeriesType T>
 void RecordTimeSeries(cyclus::Agent* agent, double value);
@@ -35,6 +41,125 @@ void RecordTimeSeries(std::string tsname, cyclus::Agent* agent, T value) {
        ->Record();
 }
 
+/// How a TimeSeriesAccumulator reduces the values it is given before they are
+/// recorded.
+enum TimeSeriesAgg {
+  /// every value is recorded, exactly as RecordTimeSeries does
+  TS_RAW,
+  /// one row holds the sum of an agent's values over a window of steps
+  TS_SUM,
+  /// one row holds the mean of an agent's values over a window of steps
+  TS_MEAN,
+  /// one row holds a run of identical consecutive values of an agent
+  TS_CHANGES,
+};
+
+/// default number of rows a TimeSeriesAccumulator buffers before recording
+/// them.
+static int const kDefaultTimeSeriesBatch = 4096;
+
+/// Buffers the values of one time series for many agents and records them in
+/// batches, optionally reducing them first.  Values are held in flat per-agent
+/// state and flat columns of finished rows rather than as one Datum per value,
+/// and the rows of a batch are recorded back to back into the same
+/// "TimeSeries" + name table.
+///
+/// With TS_RAW the table has the same AgentId, Time and Value columns as
+/// RecordTimeSeries.  Otherwise it also has a Steps column.  For TS_SUM and
+/// TS_MEAN, Time is the first step of a window of nsteps steps (windows are
+/// aligned to multiples of nsteps) and Steps is the number of values that
+/// fell into it.  For TS_CHANGES, Time is the step of the first value of a run
+/// and Steps is the number of values in the run; the value holds until the
+/// agent's next row.
+///
+/// The accumulator registers itself as an output buffer of its context, so
+/// windows and runs still open are recorded by Flush at the start of every
+/// snapshot, including the one at the end of the simulation; owners don't
+/// need to flush it themselves.  A snapshot splits the windows and runs open
+/// at that time, so rows of the same agent may share a Time; their Steps
+/// tell how to combine them (e.g. weight TS_MEAN values by Steps).  An
+/// accumulator destroyed during the simulation (e.g. with a decommissioned
+/// agent) flushes itself.  It must not outlive its context.
+///
+/// @code
+/// TimeSeriesAccumulator power(context(), POWER, TS_MEAN, 12);
+/// ...
+/// power.Add(this, power_output);  // once per time step
+/// @endcode
+class TimeSeriesAccumulator : public OutputBuffer {
+ public:
+  /// @param ctx the context that provides the time and records the rows
+  /// @param tsname the time series name; rows go to "TimeSeries" + tsname
+  /// @param agg how values are reduced before they are recorded
+  /// @param nsteps the window size for TS_SUM and TS_MEAN
+  /// @param batch the number of finished rows to buffer before recording
+  /// @throws ValueError if nsteps or batch is not positive
+  TimeSeriesAccumulator(Context* ctx, std::string tsname,
+                        TimeSeriesAgg agg = TS_RAW, int nsteps = 1,
+                        int batch = kDefaultTimeSeriesBatch);
+
+  /// Same as above for the table of a time series type.
+  TimeSeriesAccumulator(Context* ctx, TimeSeriesType t,
+                        TimeSeriesAgg agg = TS_RAW, int nsteps = 1,
+                        int batch = kDefaultTimeSeriesBatch);
+
+  /// Unregisters from the context and flushes all buffered values.
+  virtual ~TimeSeriesAccumulator();
+
+  /// Adds a value of agent at the current time step.
+  void Add(Agent* agent, double value);
+
+  /// Closes all open windows and runs and records every buffered row.
+  virtual void Flush();
+
+  /// Returns the number of finished rows waiting to be recorded.
+  inline int buffered() const {
+    return agent_ids_.size();
+  }
+
+ private:
+  // rows are recorded on destruction, so copies would record them twice
+  TimeSeriesAccumulator(const TimeSeriesAccumulator&);
+  TimeSeriesAccumulator& operator=(const TimeSeriesAccumulator&);
+
+  /// The window or run an agent's values are currently reduced into.
+  struct Open {
+    Open() : start(0), window(0), nvals(0), sum(0), last(0) {}
+    int start;
+    int window;
+    int nvals;
+    double sum;
+    double last;
+  };
+
+  void Init(int nsteps, int batch);
+
+  /// Appends a finished row to the columns, recording them if the batch is
+  /// full.
+  void Push(int agent_id, int time, double value, int steps);
+
+  /// Finishes the window or run of an agent.
+  void Close(int agent_id, Open* o);
+
+  /// Records the finished rows.
+  void Record();
+
+  Context* ctx_;
+  std::string tblname_;
+  TimeSeriesAgg agg_;
+  int nsteps_;
+  int batch_;
+
+  /// the open window or run of each agent id
+  std::map<int, Open> open_;
+
+  /// finished rows, by column
+  std::vector<int> agent_ids_;
+  std::vector<int> times_;
+  std::vector<double> values_;
+  std::vector<int> steps_;
+};
+
 }  // namespace toolkit
 }  // namespace cyclus
 
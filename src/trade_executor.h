@@ -89,6 +89,7 @@ class TradeExecutor {
       for (v_it = trades.begin(); v_it != trades.end(); ++v_it) {
         Trade<T>& trade = v_it->first;
         typename T::Ptr rsrc =  v_it->second;
+        rsrc->Traded();
         ctx->NewDatum("Transactions")
             ->AddVal("TransactionId", ctx->NextTransactionID())
             ->AddVal("SenderId", supplier->id())
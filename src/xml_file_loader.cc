@@ -437,6 +437,9 @@ void XMLFileLoader::LoadControlParams() {
   si.explicit_inventory = OptionalQuery<bool>(qe, "explicit_inventory", false);
   si.explicit_inventory_compact = OptionalQuery<bool>(qe, "explicit_inventory_compact", false);
 
+  // get resource provenance level, which the schema and InitSim validate
+  si.provenance = OptionalQuery<std::string>(qe, "provenance", "full");
+
   // get time step duration
   si.dt = OptionalQuery<int>(qe, "dt", kDefaultTimeStepDur);
 
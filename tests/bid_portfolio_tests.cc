@@ -64,6 +64,22 @@ TEST_F(BidPortfolioTests, RespAdd) {
   EXPECT_THROW(rp->AddBid(req2, get_mat(), fac2), KeyError);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(BidPortfolioTests, CompactAdd) {
+  BidPortfolio<Material>::Ptr rp(new BidPortfolio<Material>());
+  Bid<Material>* b1 = rp->AddBid(req1, get_mat(), fac1);
+  Bid<Material>* b2 = rp->AddBids(req1, get_mat(), fac1, 5);
+  Bid<Material>* b3 = rp->AddBids(req1, get_mat(), fac1, 1);
+  EXPECT_EQ(3, rp->bids().size());
+  EXPECT_EQ(1, rp->copies(b1));
+  EXPECT_EQ(5, rp->copies(b2));
+  EXPECT_EQ(1, rp->copies(b3));
+  EXPECT_TRUE(b2->exclusive());
+  EXPECT_TRUE(b3->exclusive());
+
+  EXPECT_THROW(rp->AddBids(req1, get_mat(), fac1, 0), cyclus::ValueError);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(BidPortfolioTests, Sets) {
   BidPortfolio<Material>::Ptr rp1(new BidPortfolio<Material>());
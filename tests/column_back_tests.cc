@@ -0,0 +1,178 @@
+#include <boost/filesystem.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <gtest/gtest.h>
+
+#include "blob.h"
+#include "column_back.h"
+
+static std::string const path = "columnbacktestdb.cyc";
+
+class ColumnBackTests : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    boost::filesystem::remove_all(path);
+    // small blocks so that queries span several of them
+    b = new cyclus::ColumnBack(path, 4);
+    r.RegisterBackend(b);
+  }
+
+  virtual void TearDown() {
+    r.Close();
+    delete b;
+    boost::filesystem::remove_all(path);
+  }
+
+  void RecordRows(int n) {
+    for (int i = 0; i < n; ++i) {
+      r.NewDatum("Table")
+          ->AddVal("time", i)
+          ->AddVal("qty", 0.5 * i)
+          ->AddVal("name", std::string(i % 2 == 0 ? "even" : "odd"))
+          ->Record();
+    }
+    r.Close();
+  }
+
+  cyclus::ColumnBack* b;
+  cyclus::Recorder r;
+};
+
+TEST_F(ColumnBackTests, AllTogether) {
+  std::vector<int> vect;
+  vect.push_back(4);
+  vect.push_back(2);
+  std::map<std::string, double> m;
+  m["one"] = 1.1;
+
+  boost::uuids::uuid u = boost::uuids::random_generator()();
+  r.NewDatum("DumbTitle")
+      ->AddVal("animal", std::string("monkey"))
+      ->AddVal("weight", 10)
+      ->AddVal("height", 5.5)
+      ->AddVal("ratio", 0.5f)
+      ->AddVal("alive", true)
+      ->AddVal("answer", vect)
+      ->AddVal("count", m)
+      ->AddVal("data", cyclus::Blob("banana"))
+      ->AddVal("id", u)
+      ->Record();
+  r.Close();
+
+  cyclus::QueryResult qr = b->Query("DumbTitle", NULL);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ("monkey", qr.GetVal<std::string>("animal"));
+  EXPECT_EQ(10, qr.GetVal<int>("weight"));
+  EXPECT_DOUBLE_EQ(5.5, qr.GetVal<double>("height"));
+  EXPECT_FLOAT_EQ(0.5, qr.GetVal<float>("ratio"));
+  EXPECT_TRUE(qr.GetVal<bool>("alive"));
+  EXPECT_EQ(vect, qr.GetVal<std::vector<int> >("answer"));
+  EXPECT_EQ(m, (qr.GetVal<std::map<std::string, double> >("count")));
+  EXPECT_EQ("banana", qr.GetVal<cyclus::Blob>("data").str());
+  EXPECT_EQ(u, qr.GetVal<boost::uuids::uuid>("id"));
+  EXPECT_EQ(r.sim_id(), qr.GetVal<boost::uuids::uuid>("SimId"));
+}
+
+TEST_F(ColumnBackTests, QueryAcrossBlocks) {
+  RecordRows(10);
+
+  cyclus::QueryResult qr = b->Query("Table", NULL);
+  ASSERT_EQ(10, qr.rows.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, qr.GetVal<int>("time", i));
+    EXPECT_DOUBLE_EQ(0.5 * i, qr.GetVal<double>("qty", i));
+  }
+  EXPECT_EQ("odd", qr.GetVal<std::string>("name", 9));
+}
+
+TEST_F(ColumnBackTests, Conds) {
+  RecordRows(10);
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("time", ">=", 3));
+  conds.push_back(cyclus::Cond("qty", "<", 4.0));
+  cyclus::QueryResult qr = b->Query("Table", &conds);
+  ASSERT_EQ(5, qr.rows.size());
+  EXPECT_EQ(3, qr.GetVal<int>("time", 0));
+  EXPECT_EQ(7, qr.GetVal<int>("time", 4));
+
+  conds.push_back(cyclus::Cond("name", "==", std::string("even")));
+  qr = b->Query("Table", &conds);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(4, qr.GetVal<int>("time", 0));
+  EXPECT_EQ(6, qr.GetVal<int>("time", 1));
+
+  conds.clear();
+  conds.push_back(cyclus::Cond("SimId", "==", r.sim_id()));
+  conds.push_back(cyclus::Cond("time", "==", 42));
+  qr = b->Query("Table", &conds);
+  EXPECT_EQ(0, qr.rows.size());
+
+  conds.clear();
+  conds.push_back(cyclus::Cond("SimId", "!=", r.sim_id()));
+  qr = b->Query("Table", &conds);
+  EXPECT_EQ(0, qr.rows.size());
+}
+
+TEST_F(ColumnBackTests, QueryBeforeFlush) {
+  r.set_dump_count(1);
+  r.NewDatum("Table")
+      ->AddVal("time", 1)
+      ->Record();
+
+  // the row is buffered in the backend but not yet written as a block
+  cyclus::QueryResult qr = b->Query("Table", NULL);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("time"));
+}
+
+TEST_F(ColumnBackTests, Reopen) {
+  RecordRows(6);
+  delete b;
+
+  b = new cyclus::ColumnBack(path, 4);
+  cyclus::QueryResult qr = b->Query("Table", NULL);
+  ASSERT_EQ(6, qr.rows.size());
+  EXPECT_EQ(5, qr.GetVal<int>("time", 5));
+
+  // appends go after the existing blocks
+  r.RegisterBackend(b);
+  RecordRows(2);
+  qr = b->Query("Table", NULL);
+  ASSERT_EQ(8, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("time", 7));
+}
+
+TEST_F(ColumnBackTests, ColumnTypes) {
+  r.NewDatum("IntTable")
+      ->AddVal("intcol", 42)
+      ->Record();
+  r.Close();
+
+  std::map<std::string, cyclus::DbTypes> coltypes = b->ColumnTypes("IntTable");
+  EXPECT_EQ(2, coltypes.size());  // injects simid
+  EXPECT_EQ(cyclus::INT, coltypes["intcol"]);
+  EXPECT_EQ(cyclus::UUID, coltypes["SimId"]);
+}
+
+TEST_F(ColumnBackTests, Tables) {
+  r.NewDatum("IntTable")
+      ->AddVal("intcol", 42)
+      ->Record();
+  r.Close();
+
+  std::set<std::string> tabs = b->Tables();
+  EXPECT_EQ(1, tabs.size());
+  EXPECT_EQ(1, tabs.count("IntTable"));
+  EXPECT_THROW(b->Query("NoTable", NULL), cyclus::ValueError);
+}
+
+TEST_F(ColumnBackTests, UnknownCondField) {
+  r.NewDatum("IntTable")
+      ->AddVal("intcol", 42)
+      ->Record();
+  r.Close();
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("nocol", "==", 42));
+  EXPECT_THROW(b->Query("IntTable", &conds), cyclus::ValueError);
+}
@@ -8,6 +8,7 @@
 namespace cm = cyclus::compmath;
 using cyclus::Composition;
 using cyclus::CompMap;
+using cyclus::CompVec;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(CompMathTests, SubSame) {
@@ -252,3 +253,109 @@ TEST(CompMathTests, Add) {
     EXPECT_DOUBLE_EQ(it->second, expect[it->first]);
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, VecMatchesMap) {
+  // partially overlapping nuclides
+  CompMap m1;
+  CompMap m2;
+  for (int z = 1; z <= 50; ++z) {
+    m1[z * 10000000 + (2 * z + 1) * 10000] = 0.1 * z;
+    m2[(z + 25) * 10000000 + (2 * z + 51) * 10000] = 0.03 * (z + 6);
+  }
+  CompVec v1(m1);
+  CompVec v2(m2);
+
+  EXPECT_EQ(m1, v1.ToMap());
+  EXPECT_EQ(cm::Add(m1, m2), cm::Add(v1, v2).ToMap());
+  EXPECT_EQ(cm::Sub(m1, m2), cm::Sub(v1, v2).ToMap());
+  EXPECT_EQ(cm::Sub(m2, m1), cm::Sub(v2, v1).ToMap());
+  EXPECT_DOUBLE_EQ(cm::Sum(m1), cm::Sum(v1));
+
+  cm::Normalize(&m1, 3.0);
+  cm::Normalize(&v1, 3.0);
+  EXPECT_EQ(m1, v1.ToMap());
+
+  CompMap sub = cm::Sub(m1, m2);
+  CompVec vsub = cm::Sub(v1, v2);
+  cm::ApplyThreshold(&sub, 0.5);
+  cm::ApplyThreshold(&vsub, 0.5);
+  EXPECT_EQ(sub, vsub.ToMap());
+  EXPECT_THROW(cm::ApplyThreshold(&vsub, -1), cyclus::ValueError);
+
+  EXPECT_FALSE(cm::AllPositive(cm::Sub(v1, v2)));
+  EXPECT_TRUE(cm::AllPositive(v1));
+  EXPECT_TRUE(cm::ValidNucs(v1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, VecMix) {
+  CompMap m1;
+  CompMap m2;
+  for (int z = 1; z <= 50; ++z) {
+    m1[z * 10000000 + (2 * z + 1) * 10000] = 0.1 * z;
+    m2[(z + 25) * 10000000 + (2 * z + 51) * 10000] = 0.03 * (z + 6);
+  }
+  CompVec v1(m1);
+  CompVec v2(m2);
+
+  CompVec n1(v1);
+  CompVec n2(v2);
+  cm::Normalize(&n1, 7.0);
+  cm::Normalize(&n2, 3.0);
+  EXPECT_EQ(cm::Add(n1, n2), cm::Mix(v1, 7.0, v2, 3.0));
+  EXPECT_EQ(cm::Sub(n1, n2), cm::Mix(v1, 7.0, v2, -3.0));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, VecMixMany) {
+  CompMap m1;
+  CompMap m2;
+  CompMap m3;
+  for (int z = 1; z <= 50; ++z) {
+    m1[z * 10000000 + (2 * z + 1) * 10000] = 0.1 * z;
+    m2[(z + 25) * 10000000 + (2 * z + 51) * 10000] = 0.03 * (z + 6);
+    m3[(z + 10) * 10000000 + (2 * z + 21) * 10000] = 0.7;
+  }
+  CompVec v1(m1);
+  CompVec v2(m2);
+  CompVec v3(m3);
+
+  std::vector<const CompVec*> vs;
+  vs.push_back(&v1);
+  vs.push_back(&v2);
+  vs.push_back(&v3);
+  std::vector<double> qtys;
+  qtys.push_back(7.0);
+  qtys.push_back(3.0);
+  qtys.push_back(5.0);
+
+  CompVec want = cm::Mix(cm::Mix(v1, 7.0, v2, 3.0), 10.0, v3, 5.0);
+  CompVec got = cm::Mix(vs, qtys);
+  EXPECT_EQ(want.nucs(), got.nucs());
+  EXPECT_TRUE(cm::AlmostEq(want, got, 1e-12));
+  EXPECT_DOUBLE_EQ(15.0, cm::Sum(got));
+
+  qtys.pop_back();
+  EXPECT_THROW(cm::Mix(vs, qtys), cyclus::ValueError);
+  vs.pop_back();
+  EXPECT_EQ(cm::Mix(v1, 7.0, v2, 3.0), cm::Mix(vs, qtys));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, VecAlmostEq) {
+  CompMap m;
+  m[922350000] = 1.0;
+  m[922380000] = 2.0;
+  CompVec v1(m);
+  m[922380000] = 2.0 + 1e-9;
+  CompVec v2(m);
+
+  EXPECT_TRUE(cm::AlmostEq(v1, v2, 1e-6));
+  EXPECT_FALSE(cm::AlmostEq(v1, v2, 1e-12));
+
+  m[10010000] = 1.0;
+  EXPECT_FALSE(cm::AlmostEq(v1, CompVec(m), 1e-6));
+  EXPECT_TRUE(cm::AlmostEq(CompVec(), CompVec(), 0));
+  EXPECT_THROW(cm::AlmostEq(v1, v2, -1), cyclus::ValueError);
+}
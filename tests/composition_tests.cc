@@ -50,6 +50,95 @@ TEST(CompositionTests, create_mass) {
                    2 / pyne::atomic_mass(922350000) * pyne::atomic_mass(922330000));
 }
 
+TEST(CompositionTests, create_mass_vec) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[922350000] = 2;
+  v[922330000] = 1;
+  cyclus::CompVec vec(v);
+  EXPECT_EQ(2, vec.size());
+  EXPECT_EQ(922330000, vec.nucs()[0]);
+  EXPECT_DOUBLE_EQ(2, vec.Get(922350000));
+  EXPECT_DOUBLE_EQ(0, vec.Get(922380000));
+
+  Composition::Ptr c = Composition::CreateFromMass(vec);
+  EXPECT_EQ(v, c->mass());
+  EXPECT_EQ(vec, c->mass_vec());
+  EXPECT_EQ(v, Composition::CreateFromMass(v)->mass_vec().ToMap());
+
+  vec.vals()[0] = -1;
+  EXPECT_THROW(Composition::CreateFromMass(vec), cyclus::ValueError);
+}
+
+TEST(CompositionTests, interned) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[922350000] = 2;
+  v[922380000] = 1;
+  Composition::Ptr c1 = Composition::CreateFromMass(v);
+
+  // equal up to scale
+  CompMap scaled;
+  scaled[922350000] = 4;
+  scaled[922380000] = 2;
+  Composition::Ptr c2 = Composition::CreateFromMass(scaled);
+  EXPECT_EQ(c1, c2);
+  EXPECT_EQ(c1->id(), c2->id());
+  EXPECT_EQ(c1, Composition::CreateFromMass(cyclus::CompVec(v)));
+
+  // mass and atom bases are interned separately
+  Composition::Ptr a = Composition::CreateFromAtom(v);
+  EXPECT_NE(c1, a);
+  EXPECT_EQ(a, Composition::CreateFromAtom(scaled));
+
+  v[922380000] = 1.5;
+  Composition::Ptr c3 = Composition::CreateFromMass(v);
+  EXPECT_NE(c1, c3);
+  EXPECT_NE(c1->id(), c3->id());
+
+  // released compositions are dropped from the table
+  int id = c3->id();
+  c3.reset();
+  EXPECT_NE(id, Composition::CreateFromMass(v)->id());
+}
+
+TEST(CompositionTests, max_decay_const) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[id("U235")] = 1;
+  v[id("Cs137")] = 1;
+  v[id("Pb208")] = 1;
+  Composition::Ptr c = Composition::CreateFromMass(v);
+  EXPECT_DOUBLE_EQ(pyne::decay_const(id("Cs137")), c->max_decay_const());
+
+  v.clear();
+  v[id("Pb208")] = 1;
+  EXPECT_DOUBLE_EQ(0, Composition::CreateFromMass(v)->max_decay_const());
+}
+
+TEST(CompositionTests, uranium) {
+  CompMap v;
+  v[922350000] = 1;
+  v[922380000] = 3;
+  v[80160000] = 4;
+  Composition::Ptr c = Composition::CreateFromMass(v);
+  EXPECT_DOUBLE_EQ(0.25, c->uranium_assay_mass());
+  EXPECT_DOUBLE_EQ(0.5, c->uranium_mass_frac());
+  double u235 = c->atom().at(922350000);
+  double u238 = c->atom().at(922380000);
+  EXPECT_DOUBLE_EQ(u235 / (u235 + u238), c->uranium_assay_atom());
+
+  v.clear();
+  v[80160000] = 1;
+  c = Composition::CreateFromAtom(v);
+  EXPECT_EQ(0, c->uranium_assay_atom());
+  EXPECT_EQ(0, c->uranium_assay_mass());
+  EXPECT_EQ(0, c->uranium_mass_frac());
+}
+
 TEST(CompositionTests, lineage) {
   cyclus::Env::SetNucDataPath();
 
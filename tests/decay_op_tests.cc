@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "composition.h"
+#include "decay_op.h"
+#include "env.h"
+#include "pyne.h"
+#include "pyne_decay.h"
+
+using cyclus::CompMap;
+using cyclus::DecayOp;
+using pyne::nucname::id;
+
+TEST(DecayOpTests, MatchesPyne) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[id("H3")] = 2;
+  v[id("Cs137")] = 1;
+  v[id("U238")] = 10;
+  double secs = 3.9e8;  // about one H3 half life
+
+  CompMap want = pyne::decayers::decay(v, secs);
+  CompMap got = DecayOp::Get(v, secs)->Apply(v);
+  ASSERT_EQ(want.size(), got.size());
+  CompMap::iterator it;
+  for (it = want.begin(); it != want.end(); ++it) {
+    EXPECT_DOUBLE_EQ(it->second, got[it->first]) << it->first;
+  }
+}
+
+TEST(DecayOpTests, PassThrough) {
+  cyclus::Env::SetNucDataPath();
+
+  // pyne copies nuclides without decay data as is, even with non-positive
+  // quantities, but drops non-positive daughters
+  CompMap v;
+  v[id("H1")] = 0;
+  v[id("H3")] = 2;
+  v[id("U238")] = 0;
+  v[1202950000] = 0;
+  v[1202960000] = -1;
+  double secs = 3.9e8;
+
+  CompMap want = pyne::decayers::decay(v, secs);
+  CompMap got = DecayOp::Get(v, secs)->Apply(v);
+  EXPECT_EQ(want, got);
+  EXPECT_EQ(1, got.count(1202950000));
+  EXPECT_EQ(-1, got[1202960000]);
+}
+
+TEST(DecayOpTests, Cache) {
+  cyclus::Env::SetNucDataPath();
+  DecayOp::ClearCache();
+
+  CompMap v;
+  v[id("H3")] = 1;
+  v[id("He3")] = 1;
+  DecayOp::Ptr op = DecayOp::Get(v, 1e8);
+  EXPECT_EQ(1, DecayOp::cache_size());
+  EXPECT_EQ(2, op->parents().size());
+  EXPECT_DOUBLE_EQ(1e8, op->secs());
+
+  // same nuclide set with different quantities reuses the operator
+  v[id("H3")] = 5;
+  EXPECT_EQ(op, DecayOp::Get(v, 1e8));
+  EXPECT_EQ(1, DecayOp::cache_size());
+
+  EXPECT_NE(op, DecayOp::Get(v, 2e8));
+  v[id("H1")] = 1;
+  EXPECT_NE(op, DecayOp::Get(v, 1e8));
+  EXPECT_EQ(3, DecayOp::cache_size());
+
+  EXPECT_THROW(op->Apply(v), cyclus::ValueError);
+
+  DecayOp::ClearCache();
+  EXPECT_EQ(0, DecayOp::cache_size());
+}
@@ -433,6 +433,55 @@ TEST(ExXlateTests, SimpleXlate) {
   EXPECT_EQ(pref, a.unode()->prefs[a]);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExXlateTests, XlateCompactBids) {
+  TestContext tc;
+  TestFacility* trader = tc.trader();
+
+  std::string commod = "c";
+  RequestPortfolio<Material>::Ptr rport(new RequestPortfolio<Material>());
+  Request<Material>* req =
+      rport->AddRequest(get_mat(u235, qty), trader, commod, 1.0);
+
+  BidPortfolio<Material>::Ptr bport(new BidPortfolio<Material>());
+  Bid<Material>* bid = bport->AddBids(req, get_mat(u235, qty / 4), trader, 3);
+  bport->AddBid(req, get_mat(u235, qty), trader, true);
+
+  ExchangeContext<Material> ctx;
+  ctx.AddRequestPortfolio(rport);
+  ctx.AddBidPortfolio(bport);
+
+  // one bid object expands into an independent exclusive node per copy
+  ExchangeTranslator<Material> xlator(&ctx);
+  ExchangeGraph::Ptr graph = xlator.Translate();
+  ASSERT_EQ(1, graph->supply_groups().size());
+  ExchangeNodeGroup::Ptr set = graph->supply_groups()[0];
+  EXPECT_EQ(4, set->nodes().size());
+  EXPECT_EQ(4, set->excl_node_groups().size());
+  EXPECT_EQ(4, graph->arcs().size());
+
+  const ExchangeTranslationContext<Material>& xctx = xlator.translation_ctx();
+  ASSERT_EQ(1, xctx.bid_copy_nodes.size());
+  const std::vector<ExchangeNode::Ptr>& nodes = xctx.bid_copy_nodes.at(bid);
+  ASSERT_EQ(3, nodes.size());
+  for (int i = 0; i < nodes.size(); ++i) {
+    EXPECT_TRUE(nodes[i]->exclusive);
+    EXPECT_DOUBLE_EQ(qty / 4, nodes[i]->qty);
+    EXPECT_EQ(bid, xctx.node_to_bid.at(nodes[i]));
+  }
+  EXPECT_EQ(nodes[0], xctx.bid_to_node.at(bid));
+
+  // matches on any copy trade back through the compact bid
+  std::vector<Match> matches;
+  matches.push_back(std::make_pair(graph->node_arc_map()[nodes[2]][0],
+                                   qty / 4));
+  std::vector<Trade<Material> > trades;
+  xlator.BackTranslateSolution(matches, trades);
+  ASSERT_EQ(1, trades.size());
+  EXPECT_EQ(bid, trades[0].bid);
+  EXPECT_EQ(req, trades[0].request);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(ExXlateTests, BackXlate) {
   TestContext tc;
@@ -0,0 +1,101 @@
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "error.h"
+#include "id_allocator.h"
+
+using cyclus::IdAllocator;
+using cyclus::IdBlocks;
+
+/// Allocates n ids from a in each lane of a region, running every lane on
+/// its own thread, and returns the ids of each lane.
+static std::vector<std::vector<int> > LaneIds(IdAllocator* a,
+                                              const std::vector<int>& n,
+                                              int block_size) {
+  std::vector<std::vector<int> > ids(n.size());
+  IdBlocks blocks(n.size(), block_size);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < n.size(); ++i) {
+    threads.push_back(std::thread([&, i]() {
+      IdBlocks::Lane lane(&blocks, i);
+      for (int j = 0; j < n[i]; ++j) {
+        ids[i].push_back(a->Next());
+      }
+    }));
+  }
+  for (int i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  return ids;
+}
+
+TEST(IdAllocatorTests, Sequential) {
+  IdAllocator a(5);
+  EXPECT_EQ(5, a.next());
+  EXPECT_EQ(5, a.Next());
+  EXPECT_EQ(6, a.Next());
+  a.next(42);
+  EXPECT_EQ(42, a.Next());
+}
+
+TEST(IdAllocatorTests, Concurrent) {
+  IdAllocator a(1);
+  std::vector<std::vector<int> > ids(4);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < ids.size(); ++i) {
+    threads.push_back(std::thread([&, i]() {
+      for (int j = 0; j < 1000; ++j) {
+        ids[i].push_back(a.Next());
+      }
+    }));
+  }
+  std::set<int> all;
+  for (int i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+    all.insert(ids[i].begin(), ids[i].end());
+  }
+  EXPECT_EQ(4000, all.size());
+  EXPECT_EQ(4001, a.next());
+}
+
+TEST(IdAllocatorTests, Blocks) {
+  IdAllocator a(10);
+  std::vector<int> n;
+  n.push_back(3);
+  n.push_back(25);
+  n.push_back(0);
+
+  std::vector<std::vector<int> > ids = LaneIds(&a, n, 10);
+  std::set<int> all;
+  for (int i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(n[i], ids[i].size());
+    all.insert(ids[i].begin(), ids[i].end());
+  }
+  EXPECT_EQ(28, all.size());
+
+  // lane 0 uses block 0; lane 1 uses blocks 1, 4 and 7
+  EXPECT_EQ(10, ids[0][0]);
+  EXPECT_EQ(20, ids[1][0]);
+  EXPECT_EQ(50, ids[1][10]);
+  EXPECT_EQ(80, ids[1][20]);
+  EXPECT_EQ(10 + 3 * 3 * 10, a.next());
+
+  // the same work gives the same ids however the threads are scheduled
+  a.next(10);
+  EXPECT_EQ(ids, LaneIds(&a, n, 10));
+}
+
+TEST(IdAllocatorTests, BlockErrors) {
+  IdAllocator a;
+  EXPECT_THROW(IdBlocks(0), cyclus::ValueError);
+  {
+    IdBlocks blocks(2);
+    EXPECT_THROW(IdBlocks(2), cyclus::StateError);
+    EXPECT_THROW(a.Next(), cyclus::StateError);
+    EXPECT_THROW(IdBlocks::Lane(&blocks, 2), cyclus::ValueError);
+  }
+  EXPECT_EQ(1, a.Next());
+}
@@ -131,6 +131,76 @@ TEST_F(MaterialTest, AbsorbIntoZeroMaterial) {
   Material::Ptr same_as_test_mat = Material::CreateUntracked(0, test_comp_);
   EXPECT_NO_THROW(same_as_test_mat->Absorb(test_mat_));
   EXPECT_FLOAT_EQ(test_size_, same_as_test_mat->quantity());
+
+  // an empty material takes on the absorbed composition without mixing
+  Material::Ptr empty = Material::CreateUntracked(0, test_comp_);
+  empty->Absorb(diff_mat_);
+  EXPECT_EQ(diff_comp_, empty->comp());
+
+  // absorbing an empty material leaves the composition unchanged
+  diff_mat_ = Material::CreateUntracked(test_size_, diff_comp_);
+  diff_mat_->Absorb(Material::CreateUntracked(0, test_comp_));
+  EXPECT_EQ(diff_comp_, diff_mat_->comp());
+}
+
+TEST_F(MaterialTest, AbsorbMany) {
+  CompMap v;
+  v[pb208_] = 1.0;
+  v[am241_] = 2.0;
+  Composition::Ptr third_comp = Composition::CreateFromMass(v);
+
+  // absorbing one at a time and all at once give the same material
+  std::vector<Material::Ptr> mats;
+  std::vector<Material::Ptr> copies;
+  for (int i = 0; i < 6; ++i) {
+    Composition::Ptr c = i % 3 == 0 ? test_comp_ :
+                         (i % 3 == 1 ? diff_comp_ : third_comp);
+    mats.push_back(Material::CreateUntracked((i + 1) * test_size_, c));
+    copies.push_back(Material::CreateUntracked((i + 1) * test_size_, c));
+  }
+  Material::Ptr pairwise = Material::CreateUntracked(test_size_, test_comp_);
+  for (int i = 0; i < copies.size(); ++i) {
+    pairwise->Absorb(copies[i]);
+  }
+  test_mat_->Absorb(mats);
+
+  EXPECT_DOUBLE_EQ(pairwise->quantity(), test_mat_->quantity());
+  for (int i = 0; i < mats.size(); ++i) {
+    EXPECT_EQ(0, mats[i]->quantity());
+  }
+  cyclus::toolkit::MatQuery want(pairwise);
+  cyclus::toolkit::MatQuery got(test_mat_);
+  EXPECT_TRUE(got.AlmostEq(pairwise));
+  EXPECT_DOUBLE_EQ(want.mass(u235_), got.mass(u235_));
+  EXPECT_DOUBLE_EQ(want.mass(pb208_), got.mass(pb208_));
+  EXPECT_DOUBLE_EQ(want.mass(am241_), got.mass(am241_));
+
+  // materials sharing one composition don't create a new one
+  Material::Ptr same = Material::CreateUntracked(test_size_, test_comp_);
+  mats.clear();
+  mats.push_back(Material::CreateUntracked(test_size_, test_comp_));
+  mats.push_back(Material::CreateUntracked(0, diff_comp_));
+  mats.push_back(Material::CreateUntracked(test_size_, test_comp_));
+  same->Absorb(mats);
+  EXPECT_EQ(test_comp_, same->comp());
+  EXPECT_DOUBLE_EQ(3 * test_size_, same->quantity());
+}
+
+TEST_F(MaterialTest, AbsorbManyInvalid) {
+  Material::Ptr m = Material::CreateUntracked(test_size_, diff_comp_);
+  std::vector<Material::Ptr> mats;
+  mats.push_back(m);
+  mats.push_back(test_mat_);
+  EXPECT_THROW(test_mat_->Absorb(mats), ValueError);
+
+  mats.pop_back();
+  mats.push_back(m);
+  EXPECT_THROW(test_mat_->Absorb(mats), ValueError);
+
+  // nothing is absorbed when the list is rejected
+  EXPECT_DOUBLE_EQ(test_size_, test_mat_->quantity());
+  EXPECT_DOUBLE_EQ(test_size_, m->quantity());
+  EXPECT_EQ(test_comp_, test_mat_->comp());
 }
 
 TEST_F(MaterialTest, ExtractMass) {
@@ -299,6 +369,25 @@ TEST_F(MaterialTest, DecayNever) {
   EXPECT_DOUBLE_EQ(orig_mass, tracked_mat_no_decay_->quantity());
 }
 
+TEST_F(MaterialTest, DecayAll) {
+  Material::Ptr single = Material::CreateUntracked(1, diff_comp_);
+  single->Decay(100);
+
+  std::vector<Material::Ptr> mats;
+  mats.push_back(Material::CreateUntracked(1, diff_comp_));
+  mats.push_back(Material::CreateUntracked(5, diff_comp_));
+  mats.push_back(Material::CreateUntracked(2, test_comp_));
+  Material::DecayAll(mats, 100);
+
+  // materials sharing a composition share the decayed composition
+  EXPECT_EQ(single->comp(), mats[0]->comp());
+  EXPECT_EQ(mats[0]->comp(), mats[1]->comp());
+  EXPECT_EQ(100, mats[1]->prev_decay_time());
+  EXPECT_DOUBLE_EQ(5, mats[1]->quantity());
+  EXPECT_NE(test_comp_, mats[2]->comp());
+  EXPECT_NE(mats[0]->comp(), mats[2]->comp());
+}
+
 TEST_F(MaterialTest, DecayShortcut) {
   CompMap mp;
   mp[922350000] = 1;
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include "blob.h"
+#include "mem_back.h"
+#include "sqlite_back.h"
+
+class MemBackTests : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    b = new cyclus::MemBack();
+    r.RegisterBackend(b);
+  }
+
+  virtual void TearDown() {
+    r.Close();
+    delete b;
+  }
+
+  void RecordRows(int n) {
+    for (int i = 0; i < n; ++i) {
+      r.NewDatum("Resources")
+          ->AddVal("ResourceId", i)
+          ->AddVal("QualId", i % 3)
+          ->AddVal("Quantity", 0.5 * i)
+          ->AddVal("Type", std::string(i % 2 == 0 ? "Material" : "Product"))
+          ->Record();
+    }
+    r.Flush();
+  }
+
+  cyclus::MemBack* b;
+  cyclus::Recorder r;
+};
+
+TEST_F(MemBackTests, AllTogether) {
+  std::vector<int> vect;
+  vect.push_back(4);
+  vect.push_back(2);
+
+  r.NewDatum("DumbTitle")
+      ->AddVal("animal", std::string("monkey"))
+      ->AddVal("weight", 10)
+      ->AddVal("height", 5.5)
+      ->AddVal("alive", true)
+      ->AddVal("answer", vect)
+      ->AddVal("data", cyclus::Blob("banana"))
+      ->Record();
+  r.Close();
+
+  cyclus::QueryResult qr = b->Query("DumbTitle", NULL);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ("monkey", qr.GetVal<std::string>("animal"));
+  EXPECT_EQ(10, qr.GetVal<int>("weight"));
+  EXPECT_DOUBLE_EQ(5.5, qr.GetVal<double>("height"));
+  EXPECT_TRUE(qr.GetVal<bool>("alive"));
+  EXPECT_EQ(vect, qr.GetVal<std::vector<int> >("answer"));
+  EXPECT_EQ("banana", qr.GetVal<cyclus::Blob>("data").str());
+  EXPECT_EQ(r.sim_id(), qr.GetVal<boost::uuids::uuid>("SimId"));
+}
+
+TEST_F(MemBackTests, IndexedConds) {
+  RecordRows(9);
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("SimId", "==", r.sim_id()));
+  conds.push_back(cyclus::Cond("ResourceId", "==", 4));
+  cyclus::QueryResult qr = b->Query("Resources", &conds);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_DOUBLE_EQ(2.0, qr.GetVal<double>("Quantity"));
+
+  conds.clear();
+  conds.push_back(cyclus::Cond("QualId", "==", 1));
+  conds.push_back(cyclus::Cond("Quantity", ">", 1.0));
+  qr = b->Query("Resources", &conds);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(4, qr.GetVal<int>("ResourceId", 0));
+  EXPECT_EQ(7, qr.GetVal<int>("ResourceId", 1));
+
+  conds.clear();
+  conds.push_back(cyclus::Cond("ResourceId", "==", 42));
+  qr = b->Query("Resources", &conds);
+  EXPECT_EQ(0, qr.rows.size());
+}
+
+TEST_F(MemBackTests, IndexTracksNewRows) {
+  RecordRows(3);
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("QualId", "==", 0));
+  EXPECT_EQ(1, b->Query("Resources", &conds).rows.size());
+
+  RecordRows(6);
+  EXPECT_EQ(3, b->Query("Resources", &conds).rows.size());
+}
+
+TEST_F(MemBackTests, Scan) {
+  RecordRows(6);
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("Type", "==", std::string("Product")));
+  conds.push_back(cyclus::Cond("ResourceId", "<", 5));
+  cyclus::QueryResult qr = b->Query("Resources", &conds);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("ResourceId", 0));
+  EXPECT_EQ(3, qr.GetVal<int>("ResourceId", 1));
+}
+
+TEST_F(MemBackTests, Export) {
+  RecordRows(4);
+
+  cyclus::SqliteBack disk(":memory:");
+  b->Export(&disk);
+  cyclus::QueryResult qr = disk.Query("Resources", NULL);
+  ASSERT_EQ(4, qr.rows.size());
+  EXPECT_EQ(3, qr.GetVal<int>("ResourceId", 3));
+  EXPECT_EQ(r.sim_id(), qr.GetVal<boost::uuids::uuid>("SimId", 3));
+}
+
+TEST_F(MemBackTests, Schema) {
+  RecordRows(1);
+
+  std::map<std::string, cyclus::DbTypes> coltypes = b->ColumnTypes("Resources");
+  EXPECT_EQ(5, coltypes.size());  // injects simid
+  EXPECT_EQ(cyclus::INT, coltypes["ResourceId"]);
+  EXPECT_EQ(cyclus::STRING, coltypes["Type"]);
+
+  std::set<std::string> tabs = b->Tables();
+  EXPECT_EQ(1, tabs.size());
+  EXPECT_EQ(1, tabs.count("Resources"));
+  EXPECT_THROW(b->Query("NoTable", NULL), cyclus::ValueError);
+}
+
+TEST_F(MemBackTests, UnknownCondField) {
+  RecordRows(3);
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("nocol", "==", 42));
+  EXPECT_THROW(b->Query("Resources", &conds), cyclus::ValueError);
+
+  // checked even when an earlier index lookup already rules out every row
+  conds.insert(conds.begin(), cyclus::Cond("ResourceId", "==", 42));
+  EXPECT_THROW(b->Query("Resources", &conds), cyclus::ValueError);
+}
@@ -0,0 +1,124 @@
+#include <set>
+#include <vector>
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include "env.h"
+#include "error.h"
+#include "nuc_data.h"
+#include "pyne.h"
+
+using cyclus::NucData;
+
+TEST(NucDataTests, Index) {
+  NucData::Clear();
+  int u235 = NucData::Index(922350000);
+  int am242m = NucData::Index(952420001);
+  EXPECT_EQ(2, NucData::size());
+  EXPECT_NE(u235, am242m);
+  EXPECT_EQ(u235, NucData::Index(922350000));
+  EXPECT_EQ(am242m, NucData::Index(952420001));
+  EXPECT_EQ(952420001, NucData::nuc(am242m));
+  EXPECT_EQ(2, NucData::size());
+
+  NucData::Clear();
+  EXPECT_EQ(0, NucData::size());
+}
+
+TEST(NucDataTests, AtomicMass) {
+  cyclus::Env::SetNucDataPath();
+  EXPECT_DOUBLE_EQ(pyne::atomic_mass(922350000),
+                   NucData::atomic_mass(922350000));
+  EXPECT_DOUBLE_EQ(pyne::atomic_mass(10010000), NucData::atomic_mass(10010000));
+  EXPECT_DOUBLE_EQ(pyne::atomic_mass(922350000),
+                   NucData::atomic_mass(922350000));
+}
+
+TEST(NucDataTests, Decay) {
+  cyclus::Env::SetNucDataPath();
+  int cs137 = pyne::nucname::id("Cs137");
+  EXPECT_DOUBLE_EQ(pyne::decay_const(cs137), NucData::decay_const(cs137));
+
+  std::set<int> kids = pyne::decay_children(cs137);
+  std::vector<cyclus::Nuc> want(kids.begin(), kids.end());
+  EXPECT_EQ(want, NucData::decay_children(cs137));
+}
+
+TEST(NucDataTests, DecayChain) {
+  cyclus::Env::SetNucDataPath();
+  NucData::Clear();
+
+  // looking up the grandchildren indexes nuclides not seen before
+  int u238 = pyne::nucname::id("U238");
+  std::vector<cyclus::Nuc> kids = NucData::decay_children(u238);
+  ASSERT_FALSE(kids.empty());
+  for (int i = 0; i < kids.size(); ++i) {
+    std::set<int> grandkids = pyne::decay_children(kids[i]);
+    std::vector<cyclus::Nuc> want(grandkids.begin(), grandkids.end());
+    EXPECT_EQ(want, NucData::decay_children(kids[i]));
+  }
+  std::set<int> want = pyne::decay_children(u238);
+  EXPECT_EQ(std::vector<cyclus::Nuc>(want.begin(), want.end()), kids);
+}
+
+TEST(NucDataTests, Snapshot) {
+  cyclus::Env::SetNucDataPath();
+  std::string path = "nucdatatest.snap";
+  NucData::Compile(path);
+  NucData::LoadSnapshot(path);
+  EXPECT_TRUE(NucData::snapshot_loaded());
+  EXPECT_LT(1000, NucData::size());
+
+  int cs137 = pyne::nucname::id("Cs137");
+  EXPECT_DOUBLE_EQ(pyne::atomic_mass(cs137), NucData::atomic_mass(cs137));
+  EXPECT_DOUBLE_EQ(pyne::decay_const(cs137), NucData::decay_const(cs137));
+  std::set<int> kids = pyne::decay_children(cs137);
+  std::vector<cyclus::Nuc> want(kids.begin(), kids.end());
+  EXPECT_EQ(want, NucData::decay_children(cs137));
+
+  // recompiling replaces the file without disturbing the mapped snapshot
+  NucData::Compile(path);
+  EXPECT_DOUBLE_EQ(pyne::atomic_mass(cs137), NucData::atomic_mass(cs137));
+  EXPECT_EQ(want, NucData::decay_children(cs137));
+
+  NucData::Clear();
+  EXPECT_FALSE(NucData::snapshot_loaded());
+  boost::filesystem::remove(path);
+}
+
+TEST(NucDataTests, StaleSnapshot) {
+  cyclus::Env::SetNucDataPath();
+  std::string path = "nucdatatest-stale.snap";
+  NucData::Compile(path);
+
+  std::string src = pyne::NUC_DATA_PATH;
+  std::string other = "nucdatatest-other.h5";
+  {
+    std::ofstream f(other.c_str());
+    f << "another nuclear data library";
+  }
+  pyne::NUC_DATA_PATH = other;
+  EXPECT_THROW(NucData::LoadSnapshot(path), cyclus::IOError);
+  EXPECT_FALSE(NucData::snapshot_loaded());
+  pyne::NUC_DATA_PATH = src;
+  EXPECT_NO_THROW(NucData::LoadSnapshot(path));
+
+  NucData::Clear();
+  boost::filesystem::remove(path);
+  boost::filesystem::remove(other);
+}
+
+TEST(NucDataTests, InvalidSnapshot) {
+  std::string path = "nucdatatest-bad.snap";
+  {
+    std::ofstream f(path.c_str());
+    f << "not a nuclear data snapshot";
+  }
+  EXPECT_THROW(NucData::LoadSnapshot(path), cyclus::IOError);
+  EXPECT_FALSE(NucData::snapshot_loaded());
+  EXPECT_THROW(NucData::LoadSnapshot("no-such.snap"), cyclus::IOError);
+  boost::filesystem::remove(path);
+}
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include "blob.h"
+#include "mem_back.h"
 #include "query_backend.h"
 
 template <typename T>
@@ -128,3 +129,66 @@ TEST(QueryBackendTest, CmpConds) {
   EXPECT_PRED2(CmpConds<int>, &x, &conds);
   EXPECT_PRED2(NotCmpConds<int>, &y, &conds);
 }
+
+// counts the queries passed through to the wrapped backend
+class CountingBackend : public cyclus::CondInjector {
+ public:
+  CountingBackend(cyclus::QueryableBackend* b)
+      : cyclus::CondInjector(b, std::vector<cyclus::Cond>()),
+        nqueries(0) {}
+
+  virtual cyclus::QueryResult Query(std::string table,
+                                    std::vector<cyclus::Cond>* conds) {
+    ++nqueries;
+    return cyclus::CondInjector::Query(table, conds);
+  }
+
+  int nqueries;
+};
+
+TEST(QueryBackendTest, KeyedCache) {
+  using cyclus::Cond;
+  using cyclus::QueryResult;
+
+  cyclus::MemBack mem;
+  cyclus::Recorder rec;
+  rec.RegisterBackend(&mem);
+  for (int t = 0; t < 2; ++t) {
+    for (int id = 0; id < 5; ++id) {
+      rec.NewDatum("State")
+          ->AddVal("AgentId", id)
+          ->AddVal("SimTime", t)
+          ->AddVal("val", 10 * t + id)
+          ->Record();
+    }
+  }
+  rec.Flush();
+
+  CountingBackend counter(&mem);
+  std::vector<Cond> conds;
+  conds.push_back(Cond("SimTime", "==", 1));
+  cyclus::KeyedCache cache(&counter, conds, "AgentId");
+
+  for (int id = 0; id < 5; ++id) {
+    std::vector<Cond> key;
+    key.push_back(Cond("AgentId", "==", id));
+    QueryResult qr = cache.Query("State", &key);
+    ASSERT_EQ(1, qr.rows.size());
+    EXPECT_EQ(10 + id, qr.GetVal<int>("val"));
+  }
+  EXPECT_EQ(1, counter.nqueries);
+
+  std::vector<Cond> key;
+  key.push_back(Cond("AgentId", "==", 42));
+  EXPECT_EQ(0, cache.Query("State", &key).rows.size());
+
+  // other queries go to the wrapped backend with the conditions injected
+  key.push_back(Cond("val", ">", 12));
+  key[0] = Cond("AgentId", ">=", 0);
+  QueryResult qr = cache.Query("State", &key);
+  EXPECT_EQ(2, qr.rows.size());
+  EXPECT_EQ(2, counter.nqueries);
+
+  EXPECT_THROW(cache.Query("NoTable", &key), cyclus::ValueError);
+  rec.Close();
+}
@@ -69,6 +69,14 @@ TEST_F(RequestPortfolioTests, CapAdd) {
   RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
   EXPECT_NO_THROW(rp->AddConstraint(c));
   EXPECT_EQ(*rp->constraints().begin(), c);
+
+  // equal constraints are only added once
+  CapacityConstraint<Material> same(5, test_converter);
+  rp->AddConstraint(same);
+  EXPECT_EQ(1, rp->constraints().size());
+  CapacityConstraint<Material> other(6, test_converter);
+  rp->AddConstraint(other);
+  EXPECT_EQ(2, rp->constraints().size());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
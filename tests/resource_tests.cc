@@ -1,15 +1,18 @@
 #include <gtest/gtest.h>
 
 #include "context.h"
+#include "mem_back.h"
 #include "recorder.h"
 #include "timer.h"
 #include "material.h"
 #include "product.h"
 #include "composition.h"
 #include "region.h"
+#include "toolkit/res_manip.h"
 
 using cyclus::Material;
 using cyclus::Product;
+using cyclus::QueryResult;
 
 class Dummy : public cyclus::Region {
  public:
@@ -57,6 +60,17 @@ TEST_F(ResourceTest, MaterialAbsorbGraphid) {
   EXPECT_LT(state_id, m1->state_id());
 }
 
+TEST_F(ResourceTest, MaterialAbsorbManyInvalid) {
+  std::vector<Material::Ptr> mats;
+  mats.push_back(m2);
+  mats.push_back(m1);
+  EXPECT_THROW(m1->Absorb(mats), cyclus::ValueError);
+  mats.back() = m2;
+  EXPECT_THROW(m1->Absorb(mats), cyclus::ValueError);
+  EXPECT_DOUBLE_EQ(3, m1->quantity());
+  EXPECT_DOUBLE_EQ(7, m2->quantity());
+}
+
 TEST_F(ResourceTest, MaterialExtractTrackid) {
   int obj_id = m1->obj_id();
   Material::Ptr m3 = m1->ExtractQty(2);
@@ -84,6 +98,19 @@ TEST_F(ResourceTest, ProductAbsorbGraphid) {
   EXPECT_LT(state_id, p1->state_id());
 }
 
+TEST_F(ResourceTest, ProductAbsorbManyInvalid) {
+  std::vector<Product::Ptr> prods;
+  prods.push_back(p2);
+  prods.push_back(p1);
+  int state_id = p1->state_id();
+  EXPECT_THROW(p1->Absorb(prods), cyclus::ValueError);
+  prods.back() = p2;
+  EXPECT_THROW(p1->Absorb(prods), cyclus::ValueError);
+  EXPECT_DOUBLE_EQ(3, p1->quantity());
+  EXPECT_DOUBLE_EQ(7, p2->quantity());
+  EXPECT_EQ(state_id, p1->state_id());
+}
+
 TEST_F(ResourceTest, ProductExtractTrackid) {
   int obj_id = p1->obj_id();
   Product::Ptr p3 = p1->Extract(2);
@@ -99,3 +126,108 @@ TEST_F(ResourceTest, ProductExtractGraphid) {
   EXPECT_NE(p1->state_id(), p3->state_id());
 }
 
+
+/// Runs a small product history under the given provenance level and
+/// returns the recorded Resources rows, or no rows if none were recorded.
+/// The resulting state ids, relative to the first, are appended to ids.
+static QueryResult ProvenanceRows(std::string provenance,
+                                  std::vector<int>* ids) {
+  cyclus::Timer ti;
+  cyclus::Recorder rec;
+  cyclus::MemBack back;
+  rec.RegisterBackend(&back);
+  cyclus::Context* ctx = new cyclus::Context(&ti, &rec);
+  cyclus::SimInfo si(5, 2015, 1, "");
+  si.provenance = provenance;
+  ctx->InitSim(si);
+
+  Product::Ptr p1 = Product::Create(new Dummy(ctx), 10, "bananas");
+  int base = p1->state_id();
+  Product::Ptr p2 = p1->Extract(4);
+  p2->Traded();
+  p2->Traded();  // unchanged since the last trade
+  Product::Ptr p3 = p2->Extract(1);
+  p3->Traded();
+  p1->Absorb(p2);
+  ids->push_back(p1->state_id() - base);
+  ids->push_back(p2->state_id() - base);
+  ids->push_back(p3->state_id() - base);
+  rec.Close();
+
+  QueryResult qr;
+  try {
+    qr = back.Query("Resources", NULL);
+  } catch (cyclus::ValueError err) {}  // nothing recorded
+  delete ctx;
+  return qr;
+}
+
+TEST(ResourceProvenanceTest, SquashMany) {
+  cyclus::Timer ti;
+  cyclus::Recorder rec;
+  cyclus::MemBack back;
+  rec.RegisterBackend(&back);
+  cyclus::Context* ctx = new cyclus::Context(&ti, &rec);
+  cyclus::Agent* dummy = new Dummy(ctx);
+
+  std::vector<Product::Ptr> ps;
+  std::vector<int> ids;
+  for (int i = 0; i < 4; ++i) {
+    ps.push_back(Product::Create(dummy, 1, "bananas"));
+    ids.push_back(ps.back()->state_id());
+  }
+  Product::Ptr p = cyclus::toolkit::Squash(ps);
+  EXPECT_DOUBLE_EQ(4, p->quantity());
+  rec.Close();
+
+  // one merge state instead of one state per absorbed product
+  QueryResult qr = back.Query("Resources", NULL);
+  ASSERT_EQ(5, qr.rows.size());
+  EXPECT_EQ(p->state_id(), qr.GetVal<int>("ResourceId", 4));
+  EXPECT_EQ(ids[0], qr.GetVal<int>("Parent1", 4));
+  EXPECT_EQ(ids[1], qr.GetVal<int>("Parent2", 4));
+
+  qr = back.Query("ResourceMerges", NULL);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ(p->state_id(), qr.GetVal<int>("ResourceId"));
+  EXPECT_EQ(std::vector<int>(ids.begin() + 1, ids.end()),
+            qr.GetVal<std::vector<int> >("Parents"));
+  delete ctx;
+}
+
+TEST(ResourceProvenanceTest, Levels) {
+  std::vector<int> full_ids;
+  QueryResult full = ProvenanceRows("full", &full_ids);
+  EXPECT_EQ(6, full.rows.size());
+  EXPECT_EQ("Product", full.GetVal<std::string>("Type"));
+
+  // compact provenance records the same states with integer columns
+  std::vector<int> compact_ids;
+  QueryResult compact = ProvenanceRows("compact", &compact_ids);
+  EXPECT_EQ(full_ids, compact_ids);
+  ASSERT_EQ(full.rows.size(), compact.rows.size());
+  EXPECT_EQ(full.fields.size() - 1, compact.fields.size());
+  EXPECT_EQ(1, compact.GetVal<int>("TypeId"));
+
+  // only traded states are recorded, parented to the previous trade
+  std::vector<int> trade_ids;
+  QueryResult trades = ProvenanceRows("trades", &trade_ids);
+  EXPECT_EQ(full_ids, trade_ids);
+  ASSERT_EQ(2, trades.rows.size());
+  EXPECT_EQ(0, trades.GetVal<int>("Parent1", 0));
+  EXPECT_EQ(trades.GetVal<int>("ResourceId", 0),
+            trades.GetVal<int>("Parent1", 1));
+
+  std::vector<int> off_ids;
+  EXPECT_EQ(0, ProvenanceRows("off", &off_ids).rows.size());
+  EXPECT_EQ(full_ids, off_ids);
+}
+
+TEST(ResourceProvenanceTest, UnknownLevel) {
+  cyclus::Timer ti;
+  cyclus::Recorder rec;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SimInfo si(5, 2015, 1, "");
+  si.provenance = "ful";
+  EXPECT_THROW(ctx.InitSim(si), cyclus::ValueError);
+}
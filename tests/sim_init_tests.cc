@@ -147,17 +147,17 @@ class SimInitTest : public ::testing::Test {
 
   void resetnextids() {
     Agent::next_id_ = 0;
-    cy::Resource::nextstate_id_ = 1;
-    cy::Resource::nextobj_id_ = 1;
-    cy::Composition::next_id_ = 1;
-    cy::Product::next_qualid_ = 1;
+    cy::Resource::nextstate_id_.next(1);
+    cy::Resource::nextobj_id_.next(1);
+    cy::Composition::next_id_.next(1);
+    cy::Product::next_qualid_.next(1);
   }
   int agentid() { return Agent::next_id_; }
-  int stateid() { return cy::Resource::nextstate_id_; }
-  int objid() { return cy::Resource::nextobj_id_; }
-  int compid() { return cy::Composition::next_id_; }
-  int prodid() { return cy::Product::next_qualid_; }
-  int transid(cy::Context* ctx) { return ctx->trans_id_; }
+  int stateid() { return cy::Resource::nextstate_id_.next(); }
+  int objid() { return cy::Resource::nextobj_id_.next(); }
+  int compid() { return cy::Composition::next_id_.next(); }
+  int prodid() { return cy::Product::next_qualid_.next(); }
+  int transid(cy::Context* ctx) { return ctx->trans_id_.next(); }
 
   cy::SimInfo siminfo(cy::Context* ctx) { return ctx->si_; }
   std::set<Agent*> agent_list(cy::Context* ctx) { return ctx->agent_list_; }
@@ -421,6 +421,27 @@ TEST_F(SimInitTest, InitAgentInventories) {
   }
 }
 
+TEST_F(SimInitTest, InitSharedCompositions) {
+  cy::SimInit si;
+  si.Init(&rec, b);
+
+  // the buf1 materials of both deployed agents were made from recipe1 and
+  // share a single composition once reloaded
+  std::vector<cy::Material::Ptr> mats;
+  std::set<Agent*> init_agents = agent_list(si.context());
+  std::set<Agent*>::iterator it;
+  for (it = init_agents.begin(); it != init_agents.end(); ++it) {
+    Inver* a = dynamic_cast<Inver*>(*it);
+    if (a->enter_time() != -1) {
+      mats.push_back(a->buf1.Pop<cy::Material>());
+    }
+  }
+  ASSERT_EQ(2, mats.size());
+  EXPECT_EQ(mats[0]->comp(), mats[1]->comp());
+  EXPECT_EQ(si.context()->GetRecipe("recipe1"), mats[0]->comp());
+  EXPECT_NE(mats[0]->obj_id(), mats[1]->obj_id());
+}
+
 TEST_F(SimInitTest, RestartSimInfo) {
   cy::PyStart();
   ti.RunSim();
@@ -565,3 +565,145 @@ TEST_F(SqliteBackTests, ListPairIntInt) {
   EXPECT_EQ(std::make_pair(4, 2), l.front());
   EXPECT_EQ(std::make_pair(5, 3), l.back());
 }
+
+TEST_F(SqliteBackTests, RepeatedQueryShape) {
+  for (int i = 0; i < 5; ++i) {
+    r.NewDatum("Resources")
+        ->AddVal("ResourceId", i)
+        ->AddVal("Quantity", 0.5 * i)
+        ->Record();
+  }
+  r.Close();
+
+  // the same statement is reused with different bound values
+  for (int i = 0; i < 5; ++i) {
+    std::vector<cyclus::Cond> conds;
+    conds.push_back(cyclus::Cond("ResourceId", "==", i));
+    cyclus::QueryResult qr = b->Query("Resources", &conds);
+    ASSERT_EQ(1, qr.rows.size());
+    EXPECT_DOUBLE_EQ(0.5 * i, qr.GetVal<double>("Quantity"));
+  }
+
+  // more distinct query shapes than the cache holds
+  for (int i = 0; i < cyclus::SqliteBack::kQueryCacheSize + 2; ++i) {
+    std::vector<cyclus::Cond> conds;
+    for (int j = 0; j <= i % 3; ++j) {
+      conds.push_back(cyclus::Cond("ResourceId", "<", i + j));
+    }
+    conds.push_back(cyclus::Cond("Quantity", ">=", 0.5 * (i % 7)));
+    EXPECT_NO_THROW(b->Query("Resources", &conds));
+  }
+}
+
+TEST_F(SqliteBackTests, IndexPolicy) {
+  b->index_policy(cyclus::SqliteBack::INDEX_ON_QUERY);
+  r.NewDatum("Resources")
+      ->AddVal("ResourceId", 1)
+      ->AddVal("Quantity", 2.0)
+      ->Record();
+  r.Close();
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("ResourceId", "==", 1));
+  conds.push_back(cyclus::Cond("Quantity", "==", 2.0));
+  cyclus::QueryResult qr = b->Query("Resources", &conds);
+  ASSERT_EQ(1, qr.rows.size());
+
+  cyclus::SqlStatement::Ptr stmt = b->db().Prepare(
+      "SELECT name FROM sqlite_master WHERE type='index';");
+  std::set<std::string> indexes;
+  while (stmt->Step()) {
+    indexes.insert(stmt->GetText(0, NULL));
+  }
+  EXPECT_EQ(1, indexes.count("Resources_ResourceId"));
+  EXPECT_EQ(0, indexes.count("Resources_Quantity"));
+}
+
+TEST_F(SqliteBackTests, MultiRowInsert) {
+  // enough rows for several multi-row statements plus a remainder
+  int n = 3 * cyclus::SqliteBack::kMaxInsertRows + 5;
+  for (int i = 0; i < n; ++i) {
+    r.NewDatum("Resources")
+        ->AddVal("ResourceId", i)
+        ->AddVal("Quantity", 0.5 * i)
+        ->Record();
+    r.NewDatum("Other")
+        ->AddVal("x", i)
+        ->Record();
+  }
+  r.Close();
+
+  cyclus::QueryResult qr = b->Query("Resources", NULL);
+  ASSERT_EQ(n, qr.rows.size());
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(i, qr.GetVal<int>("ResourceId", i));
+    EXPECT_DOUBLE_EQ(0.5 * i, qr.GetVal<double>("Quantity", i));
+  }
+  EXPECT_EQ(n, b->Query("Other", NULL).rows.size());
+}
+
+TEST(SqliteBackBackgroundTests, WriterThread) {
+  std::string fpath = "sqlitebackbgtest.sqlite";
+  remove(fpath.c_str());
+  cyclus::SqliteBack* b = new cyclus::SqliteBack(fpath, true);
+  EXPECT_TRUE(b->background_writes());
+
+  cyclus::Recorder r;
+  r.set_dump_count(10);
+  r.RegisterBackend(b);
+  for (int i = 0; i < 1005; ++i) {
+    r.NewDatum("Resources")
+        ->AddVal("ResourceId", i)
+        ->AddVal("Type", std::string("Material"))
+        ->Record();
+  }
+  b->Flush();
+
+  // a separate connection can read what the writer has committed
+  cyclus::SqliteDb reader(fpath, true);
+  reader.open();
+  cyclus::SqlStatement::Ptr stmt =
+      reader.Prepare("SELECT COUNT(*) FROM Resources;");
+  ASSERT_TRUE(stmt->Step());
+  EXPECT_EQ(1000, stmt->GetInt(0));
+  stmt.reset();
+  reader.close();
+
+  r.Close();
+  cyclus::QueryResult qr = b->Query("Resources", NULL);
+  ASSERT_EQ(1005, qr.rows.size());
+  EXPECT_EQ(1004, qr.GetVal<int>("ResourceId", 1004));
+  EXPECT_EQ("Material", qr.GetVal<std::string>("Type", 1004));
+
+  delete b;
+  remove(fpath.c_str());
+}
+
+TEST(SqliteBackBackgroundTests, FailedBatch) {
+  std::string fpath = "sqlitebackbgfailtest.sqlite";
+  remove(fpath.c_str());
+  cyclus::SqliteBack* b = new cyclus::SqliteBack(fpath, true);
+
+  cyclus::Recorder r;
+  r.set_dump_count(2);
+  r.RegisterBackend(b);
+
+  // the invalid table sorts first, so the batch fails before Resources is
+  // created
+  r.NewDatum("Bad Table")->AddVal("x", 1)->Record();
+  r.NewDatum("Resources")->AddVal("ResourceId", 0)->Record();
+  EXPECT_THROW(b->Flush(), cyclus::IOError);
+
+  r.NewDatum("Resources")->AddVal("ResourceId", 1)->Record();
+  r.NewDatum("Resources")->AddVal("ResourceId", 2)->Record();
+  EXPECT_NO_THROW(b->Flush());
+  r.Close();
+
+  cyclus::QueryResult qr = b->Query("Resources", NULL);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("ResourceId", 0));
+  EXPECT_EQ(2, qr.GetVal<int>("ResourceId", 1));
+
+  delete b;
+  remove(fpath.c_str());
+}
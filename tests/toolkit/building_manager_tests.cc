@@ -54,6 +54,69 @@ TEST_F(BuildingManagerTests, problem) {
   EXPECT_EQ(order2.producer, helper.producer2);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(BuildingManagerTests, repeated) {
+  cost2 = 250;
+  SetUpProblem();
+
+  std::vector<BuildOrder> orders =
+      manager.MakeBuildDecision(helper.commodity, demand);
+  ASSERT_EQ(orders.size(), 2);
+  EXPECT_EQ(orders.at(0).number, 1);
+  EXPECT_EQ(orders.at(1).number, 2);
+
+  // the same decision again
+  orders = manager.MakeBuildDecision(helper.commodity, demand);
+  ASSERT_EQ(orders.size(), 2);
+  EXPECT_EQ(orders.at(0).number, 1);
+  EXPECT_EQ(orders.at(1).number, 2);
+
+  // a new demand
+  orders = manager.MakeBuildDecision(helper.commodity, 1700);
+  ASSERT_EQ(orders.size(), 2);
+  EXPECT_EQ(orders.at(0).number, 2);
+  EXPECT_EQ(orders.at(0).producer, helper.producer1);
+  EXPECT_EQ(orders.at(1).number, 1);
+  EXPECT_EQ(orders.at(1).producer, helper.producer2);
+
+  // a new capacity
+  helper.producer2->SetCapacity(helper.commodity, 250);
+  orders = manager.MakeBuildDecision(helper.commodity, demand);
+  ASSERT_EQ(orders.size(), 2);
+  EXPECT_EQ(orders.at(0).number, 1);
+  EXPECT_EQ(orders.at(1).number, 1);
+
+  // a producer that can no longer be built
+  builder2.Unregister(helper.producer2);
+  orders = manager.MakeBuildDecision(helper.commodity, demand);
+  ASSERT_EQ(orders.size(), 1);
+  EXPECT_EQ(orders.at(0).number, 2);
+  EXPECT_EQ(orders.at(0).producer, helper.producer1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(BuildingManagerTests, removedandrepriced) {
+  cost2 = 250;
+  SetUpProblem();
+  CommodityProducer producer3;
+  producer3.Add(helper.commodity, CommodInfo(200, 400));
+  builder2.Register(&producer3);
+
+  std::vector<BuildOrder> orders =
+      manager.MakeBuildDecision(helper.commodity, 400);
+  ASSERT_EQ(orders.size(), 1);
+  EXPECT_EQ(orders.at(0).number, 2);
+  EXPECT_EQ(orders.at(0).producer, helper.producer2);
+
+  // the first column goes away while a later one gets more expensive
+  builder1.Unregister(helper.producer1);
+  helper.producer2->SetCost(helper.commodity, 1000);
+  orders = manager.MakeBuildDecision(helper.commodity, 400);
+  ASSERT_EQ(orders.size(), 1);
+  EXPECT_EQ(orders.at(0).number, 2);
+  EXPECT_EQ(orders.at(0).producer, &producer3);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(BuildingManagerTests, emptyorder) {
   SetUpProblem();
@@ -48,5 +48,37 @@ TEST_F(CommodityProducerManagerTests, differentcommodity) {
   EXPECT_EQ(manager.TotalCapacity(differentcommodity), 0.0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(CommodityProducerManagerTests, capacitychanges) {
+  manager.Register(helper.producer1);
+  manager.Register(helper.producer2);
+
+  helper.producer1->SetCapacity(helper.commodity, 2 * helper.capacity);
+  EXPECT_DOUBLE_EQ(3 * helper.capacity,
+                   manager.TotalCapacity(helper.commodity));
+
+  helper.producer2->Rm(helper.commodity);
+  EXPECT_DOUBLE_EQ(2 * helper.capacity,
+                   manager.TotalCapacity(helper.commodity));
+
+  Commodity other("other");
+  helper.producer2->Add(other, CommodInfo(3.0));
+  EXPECT_DOUBLE_EQ(3.0, manager.TotalCapacity(other));
+
+  // destroyed producers drop out of the totals
+  delete helper.producer1;
+  helper.producer1 = NULL;
+  EXPECT_EQ(1, manager.producers().size());
+  EXPECT_EQ(0.0, manager.TotalCapacity(helper.commodity));
+  EXPECT_DOUBLE_EQ(3.0, manager.TotalCapacity(other));
+
+  // so do the producers of a destroyed copy
+  CommodityProducerManager* copy = new CommodityProducerManager(manager);
+  EXPECT_DOUBLE_EQ(3.0, copy->TotalCapacity(other));
+  delete copy;
+  helper.producer2->SetCapacity(other, 4.0);
+  EXPECT_DOUBLE_EQ(4.0, manager.TotalCapacity(other));
+}
+
 }  // namespace toolkit
 }  // namespace cyclus
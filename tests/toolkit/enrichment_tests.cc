@@ -98,5 +98,57 @@ TEST_F(EnrichmentTests, enrichmentcalcs) {
   EXPECT_NEAR(swu_, SwuRequired(product_qty, assays), 1e-8);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(EnrichmentTests, batchcalcs) {
+  std::vector<double> qtys;
+  std::vector<Assays> assays;
+  for (int i = 1; i <= 5; ++i) {
+    qtys.push_back(i * mass_u_);
+    assays.push_back(Assays(feed_, product_ / i, tails_));
+  }
+
+  Assays shared(feed_, product_, tails_);
+  std::vector<double> feed = FeedQty(qtys, shared);
+  std::vector<double> tails = TailsQty(qtys, shared);
+  std::vector<double> swu = SwuRequired(qtys, shared);
+  ASSERT_EQ(5, swu.size());
+  for (int i = 0; i < qtys.size(); ++i) {
+    EXPECT_DOUBLE_EQ((i + 1) * feed_qty_, feed[i]);
+    EXPECT_DOUBLE_EQ((i + 1) * tails_qty_, tails[i]);
+    EXPECT_NEAR((i + 1) * swu_, swu[i], 1e-8);
+  }
+
+  feed = FeedQty(qtys, assays);
+  tails = TailsQty(qtys, assays);
+  swu = SwuRequired(qtys, assays);
+  std::vector<double> fracs;
+  for (int i = 0; i < qtys.size(); ++i) {
+    EXPECT_DOUBLE_EQ(FeedQty(qtys[i], assays[i]), feed[i]);
+    EXPECT_DOUBLE_EQ(TailsQty(qtys[i], assays[i]), tails[i]);
+    EXPECT_NEAR(SwuRequired(qtys[i], assays[i]), swu[i], 1e-8);
+    fracs.push_back(assays[i].Product());
+  }
+  std::vector<double> vals = ValueFunc(fracs);
+  for (int i = 0; i < fracs.size(); ++i) {
+    EXPECT_DOUBLE_EQ(ValueFunc(fracs[i]), vals[i]);
+  }
+
+  Assays bad(feed_, 1, tails_);
+  EXPECT_THROW(FeedQty(qtys, bad), ValueError);
+  EXPECT_THROW(TailsQty(qtys, bad), ValueError);
+  EXPECT_THROW(SwuRequired(qtys, bad), ValueError);
+  assays.back() = Assays(feed_, product_, -1);
+  EXPECT_THROW(FeedQty(qtys, assays), ValueError);
+  EXPECT_THROW(TailsQty(qtys, assays), ValueError);
+  EXPECT_THROW(SwuRequired(qtys, assays), ValueError);
+
+  assays.pop_back();
+  EXPECT_THROW(FeedQty(qtys, assays), ValueError);
+  EXPECT_THROW(TailsQty(qtys, assays), ValueError);
+  EXPECT_THROW(SwuRequired(qtys, assays), ValueError);
+  fracs.push_back(1);
+  EXPECT_THROW(ValueFunc(fracs), ValueError);
+}
+
 }  // namespace toolkit
 }  // namespace cyclus
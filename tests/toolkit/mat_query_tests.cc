@@ -42,6 +42,46 @@ TEST(MatQueryTests, MassAndMoles) {
   EXPECT_DOUBLE_EQ(mq.mass_frac(nucs), 1.0);  
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(MatQueryTests, Groups) {
+  Env::SetNucDataPath();
+
+  CompMap v;
+  v[922350000] = 1;
+  v[922380000] = 3;
+  v[942390000] = 2;
+  v[80160000] = 2;
+  Composition::Ptr c = Composition::CreateFromMass(v);
+  Material::Ptr m = Material::CreateUntracked(16.0, c);
+  MatQuery mq(m);
+
+  EXPECT_DOUBLE_EQ(0.5, mq.elem_mass_frac(92));
+  EXPECT_DOUBLE_EQ(0.25, mq.elem_mass_frac(94));
+  EXPECT_DOUBLE_EQ(0, mq.elem_mass_frac(95));
+  EXPECT_DOUBLE_EQ(mq.atom_frac(922350000) + mq.atom_frac(922380000),
+                   mq.elem_atom_frac(92));
+
+  EXPECT_DOUBLE_EQ(0.75, mq.mass_frac(NucGroup::Actinides()));
+  EXPECT_DOUBLE_EQ(6, mq.mass(NucGroup::Fissile()));
+  EXPECT_DOUBLE_EQ(mq.atom_frac(922350000) + mq.atom_frac(942390000),
+                   mq.atom_frac(NucGroup::Fissile()));
+
+  std::set<Nuc> nucs;
+  nucs.insert(922380000);
+  nucs.insert(80160000);
+  NucGroup g(nucs);
+  EXPECT_DOUBLE_EQ(mq.mass_frac(nucs), mq.mass_frac(g));
+  EXPECT_DOUBLE_EQ(mq.atom_frac(nucs), mq.atom_frac(g));
+
+  // other materials of the same composition share the cached sums, and
+  // repeated queries give the same answers
+  MatQuery other(Material::CreateUntracked(4.0, c));
+  EXPECT_DOUBLE_EQ(2.5, other.mass(g));
+  EXPECT_DOUBLE_EQ(0.625, mq.mass_frac(g));
+  EXPECT_DOUBLE_EQ(mq.mass_frac("U238"), mq.mass_frac(922380000));
+  EXPECT_DOUBLE_EQ(mq.mass_frac("U238"), 3.0 / 8.0);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(MatQueryTests, AlmostEq) {
   CompMap v;
@@ -195,5 +235,39 @@ TEST_F(MaterialMatQueryTest, ExtractDiffComp) {
   EXPECT_NE(orig_u235, mq.mass(u235_));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(MatQueryTests, InterleavedComps) {
+  CompMap v;
+  v[922350000] = 1;
+  Composition::Ptr c1 = Composition::CreateFromMass(v);
+  v.clear();
+  v[922380000] = 1;
+  Composition::Ptr c2 = Composition::CreateFromMass(v);
+
+  // each live composition keeps its own aggregates while both are queried
+  Material::Ptr m1 = Material::CreateUntracked(1, c1);
+  Material::Ptr m2 = Material::CreateUntracked(1, c2);
+  MatQuery mq(m1);
+  EXPECT_FALSE(mq.AlmostEq(m2, 1e-6));
+  EXPECT_EQ(0, mq.Amount(c2));
+  EXPECT_DOUBLE_EQ(1, mq.Amount(c1));
+  EXPECT_DOUBLE_EQ(1, mq.mass(922350000));
+  EXPECT_DOUBLE_EQ(1, MatQuery(m2).mass(922380000));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(MatQueryTests, ReleasedComps) {
+  // a new composition may be allocated at a released one's address and
+  // must not pick up its aggregates
+  for (int i = 1; i <= 4; ++i) {
+    CompMap v;
+    v[922350000] = i;
+    v[922380000] = 4 - i;
+    Material::Ptr m = Material::CreateUntracked(
+        4, Composition::CreateFromMass(v));
+    EXPECT_DOUBLE_EQ(i, MatQuery(m).mass(922350000));
+  }
+}
+
 }  // namespace toolkit
 }  // namespace cyclus
@@ -126,5 +126,46 @@ TEST_F(MatlBuyPolicyTests, Reqs) {
   ASSERT_FLOAT_EQ(req->target()->quantity(), quantize);
 }
 
+TEST_F(MatlBuyPolicyTests, ReqsReused) {
+  double cap = 5;
+  ResBuf<Material> buff;
+  buff.capacity(cap);
+  cyclus::Composition::Ptr c = cyclus::Composition::Ptr(new TestComp());
+  MatlBuyPolicy p;
+
+  // unchanged requests hand out the same portfolio
+  p.Init(fac1, &buff, "").Set("foo", c);
+  std::set<RequestPortfolio<Material>::Ptr> obs = p.GetMatlRequests();
+  ASSERT_EQ(obs.size(), 1);
+  RequestPortfolio<Material>::Ptr port = *obs.begin();
+  EXPECT_EQ(port, *p.GetMatlRequests().begin());
+
+  // a different quantity or commodity set rebuilds it
+  buff.Push(Material::CreateUntracked(1, c));
+  obs = p.GetMatlRequests();
+  EXPECT_NE(port, *obs.begin());
+  EXPECT_FLOAT_EQ((*obs.begin())->requests().at(0)->target()->quantity(),
+                  cap - 1);
+  port = *obs.begin();
+  p.Set("bar", c);
+  obs = p.GetMatlRequests();
+  EXPECT_NE(port, *obs.begin());
+  EXPECT_EQ((*obs.begin())->requests().size(), 2);
+
+  // quantized requests keep the pooled portfolios they still need
+  buff.Pop();
+  double quantize = 1;
+  p.Init(fac1, &buff, "", std::numeric_limits<double>::max(), 1, 1, quantize);
+  obs = p.GetMatlRequests();
+  ASSERT_EQ(obs.size(), 5);
+  buff.Push(Material::CreateUntracked(2, c));
+  std::set<RequestPortfolio<Material>::Ptr> fewer = p.GetMatlRequests();
+  ASSERT_EQ(fewer.size(), 3);
+  std::set<RequestPortfolio<Material>::Ptr>::iterator it;
+  for (it = fewer.begin(); it != fewer.end(); ++it) {
+    EXPECT_EQ(1, obs.count(*it));
+  }
+}
+
 }
 }
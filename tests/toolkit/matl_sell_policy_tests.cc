@@ -98,7 +98,10 @@ TEST_F(MatlSellPolicyTests, Bids) {
   p.Init(NULL, &buff, "", qty, true, qty / 2).Set(commod);
   obs = p.GetMatlBids(reqs);
   ASSERT_EQ(obs.size(), 1);
-  ASSERT_EQ((*obs.begin())->bids().size(), 2);
+  // both quanta are offered by one compact bid
+  ASSERT_EQ((*obs.begin())->bids().size(), 1);
+  ASSERT_EQ((*obs.begin())->copies(*(*obs.begin())->bids().begin()), 2);
+  ASSERT_TRUE((*(*obs.begin())->bids().begin())->exclusive());
   ASSERT_FLOAT_EQ((*(*obs.begin())->bids().begin())->offer()->quantity(),
                   mat->quantity() / 2);
   ASSERT_EQ((*(*obs.begin())->bids().begin())->offer()->comp(), comp1);
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "error.h"
+#include "toolkit/nuc_group.h"
+
+namespace cyclus {
+namespace toolkit {
+
+TEST(NucGroupTests, Members) {
+  std::set<Nuc> nucs;
+  nucs.insert(922350000);
+  nucs.insert(942390000);
+  NucGroup g(nucs);
+  EXPECT_TRUE(g.Contains(922350000));
+  EXPECT_TRUE(g.Contains(942390000));
+  EXPECT_FALSE(g.Contains(922380000));
+
+  std::vector<std::string> names;
+  names.push_back("Pu");
+  names.push_back("U235");
+  NucGroup named(names);
+  EXPECT_TRUE(named.Contains(922350000));
+  EXPECT_TRUE(named.Contains(942380000));
+  EXPECT_TRUE(named.Contains(942410000));
+  EXPECT_FALSE(named.Contains(922380000));
+
+  names.push_back("notanuc");
+  EXPECT_THROW(NucGroup bad(names), ValueError);
+}
+
+TEST(NucGroupTests, Ids) {
+  NucGroup g1((std::set<Nuc>()));
+  NucGroup g2((std::set<Nuc>()));
+  NucGroup copy(g1);
+  EXPECT_NE(g1.id(), g2.id());
+  EXPECT_EQ(g1.id(), copy.id());
+  EXPECT_EQ(NucGroup::Actinides().id(), NucGroup::Actinides().id());
+}
+
+TEST(NucGroupTests, Predefined) {
+  EXPECT_TRUE(NucGroup::Actinides().Contains(892250000));
+  EXPECT_TRUE(NucGroup::Actinides().Contains(952410000));
+  EXPECT_TRUE(NucGroup::Actinides().Contains(1032600000));
+  EXPECT_FALSE(NucGroup::Actinides().Contains(882260000));
+  EXPECT_FALSE(NucGroup::Actinides().Contains(1042670000));
+
+  EXPECT_TRUE(NucGroup::Fissile().Contains(922350000));
+  EXPECT_TRUE(NucGroup::Fissile().Contains(942410000));
+  EXPECT_FALSE(NucGroup::Fissile().Contains(922380000));
+}
+
+}  // namespace toolkit
+}  // namespace cyclus
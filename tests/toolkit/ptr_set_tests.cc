@@ -0,0 +1,48 @@
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "toolkit/ptr_set.h"
+
+using cyclus::toolkit::PtrSet;
+
+TEST(PtrSetTests, InsertErase) {
+  int a, b;
+  PtrSet s;
+  EXPECT_FALSE(s.count(&a));
+  EXPECT_FALSE(s.erase(&a));
+
+  EXPECT_TRUE(s.insert(&a));
+  EXPECT_FALSE(s.insert(&a));
+  EXPECT_TRUE(s.count(&a));
+  EXPECT_FALSE(s.count(&b));
+  EXPECT_EQ(1, s.size());
+
+  EXPECT_TRUE(s.erase(&a));
+  EXPECT_FALSE(s.count(&a));
+  EXPECT_EQ(0, s.size());
+}
+
+TEST(PtrSetTests, MatchesStdSet) {
+  // churn enough members to force collisions, growth and backward shifts
+  std::vector<int> objs(5000);
+  std::set<const void*> want;
+  PtrSet s;
+  for (int i = 0; i < 20000; ++i) {
+    const void* p = &objs[(i * 7919) % objs.size()];
+    if (i % 3 == 2) {
+      EXPECT_EQ(want.erase(p) == 1, s.erase(p));
+    } else {
+      EXPECT_EQ(want.insert(p).second, s.insert(p));
+    }
+  }
+  EXPECT_EQ(want.size(), s.size());
+  for (int i = 0; i < objs.size(); ++i) {
+    EXPECT_EQ(want.count(&objs[i]) == 1, s.count(&objs[i]));
+  }
+
+  s.clear();
+  EXPECT_EQ(0, s.size());
+  EXPECT_FALSE(s.count(&objs[0]));
+}
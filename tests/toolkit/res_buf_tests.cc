@@ -355,5 +355,32 @@ TEST_F(ResBufTest, PushAll_DuplicateEmpty) {
   EXPECT_DOUBLE_EQ(store_.quantity(), mat1_->quantity() + mat2_->quantity());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResBufTest, ChurnWrapsAndKeepsQuantity) {
+  // cycle many resources through the buffer so storage wraps and grows, and
+  // check the running quantity doesn't drift
+  ProdVec held;
+  for (int i = 0; i < 50; ++i) {
+    Product::Ptr p = Product::CreateUntracked(0.1, "bananas");
+    store_.Push(p);
+    held.push_back(p);
+  }
+  for (int i = 0; i < 100000; ++i) {
+    Product::Ptr p = store_.Pop();
+    EXPECT_EQ(held[i % held.size()], p);
+    store_.Push(p);
+  }
+  EXPECT_EQ(50, store_.count());
+  EXPECT_NEAR(5.0, store_.quantity(), 1e-12);
+  EXPECT_THROW(store_.Push(held[7]), KeyError);
+
+  ProdVec popped = store_.PopN(49);
+  EXPECT_EQ(held.back(), store_.Peek());
+  EXPECT_EQ(held[0], popped[0]);
+  ASSERT_NO_THROW(store_.Push(popped));
+  EXPECT_EQ(held.back(), store_.Pop());
+  EXPECT_NEAR(4.9, store_.quantity(), 1e-12);
+}
+
 }  // namespace toolkit
 }  // namespace cyclus
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "toolkit/ring_buf.h"
+
+using cyclus::toolkit::RingBuf;
+
+TEST(RingBufTests, PushPop) {
+  RingBuf<int> b;
+  EXPECT_TRUE(b.empty());
+  b.push_back(2);
+  b.push_back(3);
+  b.push_front(1);
+  ASSERT_EQ(3, b.size());
+  EXPECT_EQ(1, b.front());
+  EXPECT_EQ(3, b.back());
+  EXPECT_EQ(2, b[1]);
+
+  b.pop_front();
+  EXPECT_EQ(2, b.front());
+  b.pop_back();
+  EXPECT_EQ(2, b.back());
+  EXPECT_EQ(1, b.size());
+
+  b.clear();
+  EXPECT_TRUE(b.empty());
+}
+
+TEST(RingBufTests, WrapAndGrow) {
+  RingBuf<int> b;
+  for (int i = 0; i < 6; ++i) {
+    b.push_back(i);
+  }
+  std::size_t cap = b.capacity();
+
+  // move the head around the storage without growing it
+  for (int i = 6; i < 100; ++i) {
+    b.pop_front();
+    b.push_back(i);
+  }
+  EXPECT_EQ(cap, b.capacity());
+  for (int i = 0; i < b.size(); ++i) {
+    EXPECT_EQ(94 + i, b[i]);
+  }
+
+  // grow while wrapped, from both ends
+  for (int i = 0; i < 20; ++i) {
+    b.push_back(100 + i);
+    b.push_front(93 - i);
+  }
+  ASSERT_EQ(46, b.size());
+  EXPECT_LT(cap, b.capacity());
+  for (int i = 0; i < b.size(); ++i) {
+    EXPECT_EQ(74 + i, b[i]);
+  }
+}
@@ -38,6 +38,28 @@ TEST_F(SDManagerTests, supply) {
             helper->nproducers*helper->capacity);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SDManagerTests, supplychanges) {
+  manager.RegisterCommodity(helper->commodity, demand);
+  manager.RegisterProducerManager(&helper->manager);
+
+  helper->producer1->SetCapacity(helper->commodity, 0.5 * helper->capacity);
+  EXPECT_DOUBLE_EQ(1.5 * helper->capacity, manager.Supply(helper->commodity));
+
+  CommodityProducer producer;
+  producer.Add(helper->commodity, CommodInfo(1.0));
+  helper->manager.Register(&producer);
+  EXPECT_DOUBLE_EQ(1.5 * helper->capacity + 1.0,
+                   manager.Supply(helper->commodity));
+  helper->manager.Unregister(&producer);
+  EXPECT_DOUBLE_EQ(1.5 * helper->capacity, manager.Supply(helper->commodity));
+
+  manager.UnregisterProducerManager(&helper->manager);
+  EXPECT_EQ(0.0, manager.Supply(helper->commodity));
+  helper->producer2->SetCapacity(helper->commodity, 1.0);
+  EXPECT_EQ(0.0, manager.Supply(helper->commodity));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(SDManagerTests, demand) {
   EXPECT_NO_THROW(manager.RegisterCommodity(helper->commodity, demand));
@@ -1,6 +1,7 @@
 #include "symbolic_function_tests.h"
 
 #include <math.h>
+#include <algorithm>
 #include <limits>
 
 #include <gtest/gtest.h>
@@ -165,6 +166,68 @@ TEST_F(SymbolicFunctionTests, piecewisefunc) {
   // output.close();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SymbolicFunctionTests, piecewisevalues) {
+  SymFunction::Ptr f = GetPiecewiseFunction();
+
+  std::vector<double> xs;
+  for (int i = -4; i < 60; ++i) {
+    xs.push_back(0.25 * i);
+  }
+  std::vector<double> ys = f->values(xs);
+  ASSERT_EQ(xs.size(), ys.size());
+  for (int i = 0; i < xs.size(); ++i) {
+    EXPECT_DOUBLE_EQ(f->value(xs[i]), ys[i]);
+  }
+
+  // out of order arguments work too
+  std::reverse(xs.begin(), xs.end());
+  std::swap(xs[3], xs[40]);
+  ys = f->values(xs);
+  for (int i = 0; i < xs.size(); ++i) {
+    EXPECT_DOUBLE_EQ(f->value(xs[i]), ys[i]);
+  }
+}
+
+/// A function the piecewise compiler can't inline.
+class SquareFunction : public SymFunction {
+ public:
+  virtual double value(double x) { return x * x; }
+  virtual std::string Print() { return "y = x^2"; }
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SymbolicFunctionTests, piecewisenested) {
+  SymFunction::Ptr lin = GetLinFunction();
+  SymFunction::Ptr exp = GetExpFunction();
+  SymFunction::Ptr sq(new SquareFunction());
+
+  PiecewiseFunctionFactory inner;
+  inner.AddFunction(lin, 1, false);
+  inner.AddFunction(exp, 3, false);
+  PiecewiseFunctionFactory outer;
+  outer.AddFunction(inner.GetFunctionPtr(), 2, false);
+  outer.AddFunction(sq, 10, false);
+  SymFunction::Ptr f = outer.GetFunctionPtr();
+
+  for (int i = 0; i < 60; ++i) {
+    double x = 0.25 * i;
+    double expected = 0;
+    if (x >= 10) {
+      expected = (x - 10) * (x - 10);
+    } else if (x >= 5) {
+      expected = exp_value(x - 5);
+    } else if (x >= 3) {
+      expected = linear_value(x - 3);
+    }
+    EXPECT_NEAR(expected, f->value(x), 1e-9) << "x = " << x;
+  }
+
+  // appending to a function that was already evaluated recompiles it
+  outer.AddFunction(lin, 12, false);
+  EXPECT_DOUBLE_EQ(linear_value(1), f->value(13));
+}
+
 TEST(BasicFunctionFactory, constructors) {
   BasicFunctionFactory bff;
   ASSERT_NO_THROW(bff.GetFunctionPtr("lin", "0 5"));
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include "agent.h"
+#include "mem_back.h"
+#include "sim_init.h"
 
 #include "../test_context.h"
 #include "../test_agents/test_agent.h"
@@ -48,6 +50,137 @@ TEST(TimeSeriesTests, RawPower) {
   RecordTimeSeries<double>("Power", a, 42.0);
 }
 
+/// Adds a value for each of a and b at every time step, recording the
+/// accumulated rows into a memory backend.
+static QueryResult Accumulate(TimeSeriesAgg agg, int nsteps,
+                              const std::vector<double>& avals,
+                              const std::vector<double>& bvals,
+                              int batch = kDefaultTimeSeriesBatch) {
+  Recorder rec;
+  Timer ti;
+  FakeContext ctx(&ti, &rec);
+  MemBack back;
+  rec.RegisterBackend(&back);
+
+  Agent* a = new TestAgent(&ctx);
+  Agent* b = new TestAgent(&ctx);
+  {
+    TimeSeriesAccumulator acc(&ctx, "Test", agg, nsteps, batch);
+    for (int t = 0; t < avals.size(); ++t) {
+      ctx.time(t);
+      acc.Add(a, avals[t]);
+      if (t < bvals.size()) {
+        acc.Add(b, bvals[t]);
+      }
+    }
+    if (batch < kDefaultTimeSeriesBatch) {
+      EXPECT_LT(acc.buffered(), batch);
+    }
+  }
+  rec.Flush();
+
+  std::vector<Cond> conds;
+  conds.push_back(Cond("AgentId", "==", a->id()));
+  QueryResult qr = back.Query("TimeSeriesTest", &conds);
+  rec.Close();
+  return qr;
+}
+
+TEST(TimeSeriesTests, AccumulateRaw) {
+  double vals[] = {1, 2, 3, 4, 5};
+  std::vector<double> avals(vals, vals + 5);
+  QueryResult qr = Accumulate(TS_RAW, 1, avals, avals, 3);
+  ASSERT_EQ(5, qr.rows.size());
+  EXPECT_EQ(3, qr.fields.size() - 1);  // SimId, AgentId, Time, Value
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(i, qr.GetVal<int>("Time", i));
+    EXPECT_EQ(vals[i], qr.GetVal<double>("Value", i));
+  }
+}
+
+TEST(TimeSeriesTests, AccumulateSumMean) {
+  double vals[] = {1, 2, 3, 4, 5, 6, 7};
+  std::vector<double> avals(vals, vals + 7);
+  std::vector<double> bvals(vals, vals + 2);
+
+  QueryResult qr = Accumulate(TS_SUM, 3, avals, bvals);
+  ASSERT_EQ(3, qr.rows.size());
+  EXPECT_EQ(0, qr.GetVal<int>("Time", 0));
+  EXPECT_DOUBLE_EQ(6, qr.GetVal<double>("Value", 0));
+  EXPECT_EQ(3, qr.GetVal<int>("Steps", 0));
+  EXPECT_EQ(3, qr.GetVal<int>("Time", 1));
+  EXPECT_DOUBLE_EQ(15, qr.GetVal<double>("Value", 1));
+  EXPECT_EQ(6, qr.GetVal<int>("Time", 2));
+  EXPECT_DOUBLE_EQ(7, qr.GetVal<double>("Value", 2));
+  EXPECT_EQ(1, qr.GetVal<int>("Steps", 2));
+
+  qr = Accumulate(TS_MEAN, 3, avals, bvals, 1);
+  ASSERT_EQ(3, qr.rows.size());
+  EXPECT_DOUBLE_EQ(2, qr.GetVal<double>("Value", 0));
+  EXPECT_DOUBLE_EQ(5, qr.GetVal<double>("Value", 1));
+  EXPECT_DOUBLE_EQ(7, qr.GetVal<double>("Value", 2));
+}
+
+TEST(TimeSeriesTests, AccumulateChanges) {
+  double vals[] = {0, 0, 0, 5, 5, 0, 2, 2};
+  std::vector<double> avals(vals, vals + 8);
+  QueryResult qr = Accumulate(TS_CHANGES, 1, avals, avals, 2);
+  ASSERT_EQ(4, qr.rows.size());
+  int times[] = {0, 3, 5, 6};
+  int steps[] = {3, 2, 1, 2};
+  double values[] = {0, 5, 0, 2};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(times[i], qr.GetVal<int>("Time", i));
+    EXPECT_EQ(steps[i], qr.GetVal<int>("Steps", i));
+    EXPECT_EQ(values[i], qr.GetVal<double>("Value", i));
+  }
+}
+
+TEST(TimeSeriesTests, AccumulateSnapshots) {
+  Recorder rec;
+  Timer ti;
+  FakeContext ctx(&ti, &rec);
+  MemBack back;
+  rec.RegisterBackend(&back);
+  Agent* a = new TestAgent(&ctx);
+  TimeSeriesAccumulator acc(&ctx, "Test", TS_SUM, 12);
+
+  // every snapshot, including the one ending a simulation, records the
+  // open windows
+  for (int t = 0; t < 5; ++t) {
+    ctx.time(t);
+    acc.Add(a, 1);
+  }
+  SimInit::Snapshot(&ctx);
+  rec.Flush();
+  QueryResult qr = back.Query("TimeSeriesTest", NULL);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ(0, qr.GetVal<int>("Time", 0));
+  EXPECT_EQ(5, qr.GetVal<int>("Steps", 0));
+  EXPECT_DOUBLE_EQ(5, qr.GetVal<double>("Value", 0));
+
+  for (int t = 5; t < 7; ++t) {
+    ctx.time(t);
+    acc.Add(a, 2);
+  }
+  SimInit::Snapshot(&ctx);
+  rec.Flush();
+  qr = back.Query("TimeSeriesTest", NULL);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(0, qr.GetVal<int>("Time", 1));
+  EXPECT_EQ(2, qr.GetVal<int>("Steps", 1));
+  EXPECT_DOUBLE_EQ(4, qr.GetVal<double>("Value", 1));
+  EXPECT_EQ(0, acc.buffered());
+  rec.Close();
+}
+
+TEST(TimeSeriesTests, AccumulateErrors) {
+  TestContext tc;
+  EXPECT_THROW(TimeSeriesAccumulator(tc.get(), POWER, TS_SUM, 0),
+               ValueError);
+  EXPECT_THROW(TimeSeriesAccumulator(tc.get(), "Power", TS_RAW, 1, 0),
+               ValueError);
+}
 
 }  // namespace toolkit
 }  // namespace cyclus